@@ -23,6 +23,9 @@
 *  @return IPWIN_RET_SUCCESS (0) or IPWIN_RET_NODATA (-1), IPWIN_RET_ERROR (-2), IPWIN_RET_STREAMEND (-3)
 *  int IMAI_enqueue(const float *data_in);
 * 
+*  @description: Drops the data enqueued so far and the LSTM state (e.g. after a gap in the input stream).
+*  void IMAI_reset(void);
+* 
 *  @description: Closes and flushes streams, free any heap allocated memory.
 *  void IMAI_finalize(void);
 * 
@@ -121,6 +124,7 @@ typedef int64_t q63_t;       // 64-bit fractional data type in Q1.63 format.
 // Exported methods
 int IMAI_dequeue(float *restrict data_out);
 int IMAI_enqueue(const float *restrict data_in);
+void IMAI_reset(void);
 void IMAI_finalize(void);
 int IMAI_init(void);
 
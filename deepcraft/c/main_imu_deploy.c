@@ -70,6 +70,8 @@
 
 #include "model.h"
 
+#include "binlog.h"
+
 // Add those modules in your makefile
 // For FreeRTOS
 // COMPONENTS+=FREERTOS
@@ -77,6 +79,8 @@
 // For model deployment
 // COMPONENTS+=ML_TFLM ML_FLOAT32
 // DEFINES+=TF_LITE_STATIC_MEMORY
+//
+// For the binary log: binlog.c / binlog.h of radar_dsp/src/c
 
 #define _I2C_TIMEOUT_MS            (10U)
 #define _READ_WRITE_LEN            (46U)
@@ -397,6 +401,30 @@ static bool _config_hw(dev_bmi270_t* dev, int rate, int accel_range, int gyro_ra
 
 QueueHandle_t data_queue = NULL;
 
+// Messages of the binary log (decoded on the host by radar_dsp/src/python/binlog_decode.py)
+#define IMU_LOG_MESSAGES(X) \
+	X(LOG_DEQUEUE_TIME, 1, "Dequeue takes: %u ms") \
+	X(LOG_CLASS_OUTPUT, 2, "class %u: %.1f")
+
+enum { IMU_LOG_MESSAGES(BINLOG_ENUM) };
+
+// Records not sent yet (sent by log_task)
+#define LOG_RECORD_COUNT 64U
+
+static binlog_t imu_log;
+static binlog_record_t log_records[LOG_RECORD_COUNT];
+
+static uint32_t _log_timestamp(void)
+{
+	return (uint32_t)clock_get_tick();
+}
+
+static void _log_output(const uint8_t* data, uint32_t len)
+{
+	fwrite(data, 1, len, stdout);
+	fflush(stdout);
+}
+
 void imu_collection_task(void* params)
 {
 	const TickType_t delay_time = 5 / portTICK_PERIOD_MS;
@@ -448,14 +476,13 @@ void inference_task(void* params)
 		{
 			case IMAI_RET_SUCCESS:
 				clock_tick_t stop_time = clock_get_tick();
-				printf("Dequeue takes: %d ms\r\n",
-				(int)((((float)(stop_time - start_time) / (float)CLOCK_TICK_PER_SECOND)) * 1000.f));
+				binlog_write(&imu_log, LOG_DEQUEUE_TIME, 1, (uint32_t)(((stop_time - start_time) * 1000U) / CLOCK_TICK_PER_SECOND), 0, 0, 0);
 
+				// Stored only: sent by log_task, formatted on the host
 				for (int i = 0; i < IMAI_DATA_OUT_COUNT; ++i)
 				{
-					printf("%.1f\t", data_out[i]);
+					binlog_write(&imu_log, LOG_CLASS_OUTPUT, 2, (uint32_t)i, binlog_float(data_out[i]), 0, 0);
 				}
-				printf("\r\n");
 
 				break;
 			case IMAI_RET_NODATA:
@@ -467,6 +494,21 @@ void inference_task(void* params)
 	}
 }
 
+/**
+ * @brief Lowest priority task: sends the records of the binary log (the other tasks never wait for the UART)
+ */
+void log_task(void* params)
+{
+	const TickType_t delay_time = 10 / portTICK_PERIOD_MS;
+
+	for(;;)
+	{
+		while (binlog_flush(&imu_log, _log_output, LOG_RECORD_COUNT) > 0) {}
+
+		vTaskDelay(delay_time);
+	}
+}
+
 /*******************************************************************************
 * Function Name: main
 ********************************************************************************
@@ -520,6 +562,12 @@ int main(void)
     	return 0;
     }
 
+    if (binlog_init(&imu_log, log_records, LOG_RECORD_COUNT, _log_timestamp) != 0)
+    {
+    	printf("Cannot init log...\r\n");
+    	return 0;
+    }
+
     // Create queue
     data_queue = xQueueCreate(100, 6 * sizeof(float));
 
@@ -538,6 +586,13 @@ int main(void)
 			configMAX_PRIORITIES - 1,
 			NULL);
 
+    xTaskCreate(log_task,
+    		"log_task",
+			configMINIMAL_STACK_SIZE * 4,
+			NULL,
+			tskIDLE_PRIORITY + 1,
+			NULL);
+
     vTaskStartScheduler();
 
     printf("oops\r\n");
@@ -0,0 +1,134 @@
+/*
+ * binlog.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ * Rutronik Elektronische Bauelemente GmbH Disclaimer: The evaluation board
+ * including the software is for testing purposes only and,
+ * because it has limited functions and limited resilience, is not suitable
+ * for permanent use under real conditions. If the evaluation board is
+ * nevertheless used under real conditions, this is done at one’s responsibility;
+ * any liability of Rutronik is insofar excluded
+ */
+
+#include "binlog.h"
+
+int32_t binlog_init(binlog_t* log, binlog_record_t* records, uint32_t record_count, uint32_t (*timestamp)(void))
+{
+	if ((log == NULL) || (records == NULL)) return -1;
+	if ((record_count == 0) || ((record_count & (record_count - 1)) != 0)) return -2;
+
+	log->records = records;
+	log->mask = record_count - 1;
+	log->timestamp = timestamp;
+	atomic_init(&log->head, 0);
+	atomic_init(&log->tail, 0);
+	atomic_init(&log->lost, 0);
+
+	// Sequence of a free record never matches its next reservation
+	for (uint32_t i = 0; i < record_count; ++i)
+	{
+		atomic_init(&records[i].sequence, 0);
+	}
+
+	return 0;
+}
+
+bool binlog_write(binlog_t* log, uint16_t id, uint16_t arg_count, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3)
+{
+	// Reserve a record
+	uint_fast32_t head = atomic_load_explicit(&log->head, memory_order_relaxed);
+	do
+	{
+		if ((uint32_t)(head - atomic_load_explicit(&log->tail, memory_order_acquire)) > log->mask)
+		{
+			atomic_fetch_add_explicit(&log->lost, 1, memory_order_relaxed);
+			return false;
+		}
+	} while (!atomic_compare_exchange_weak_explicit(&log->head, &head, head + 1, memory_order_relaxed, memory_order_relaxed));
+
+	binlog_record_t* record = &log->records[head & log->mask];
+	record->timestamp = (log->timestamp != NULL) ? log->timestamp() : 0;
+	record->id = id;
+	record->arg_count = (arg_count > BINLOG_MAX_ARGS) ? BINLOG_MAX_ARGS : arg_count;
+	record->args[0] = a0;
+	record->args[1] = a1;
+	record->args[2] = a2;
+	record->args[3] = a3;
+
+	// Commit: the consumer reads the record once its sequence matches
+	atomic_store_explicit(&record->sequence, head + 1, memory_order_release);
+
+	return true;
+}
+
+/**
+ * @brief Encode and send one record (see binlog_flush)
+ */
+static void binlog_send(binlog_output_t output, uint16_t id, uint32_t timestamp, uint16_t arg_count, const uint32_t* args)
+{
+	uint8_t buffer[3U + 2U + 4U + 4U * BINLOG_MAX_ARGS];
+	uint32_t len = 2;
+
+	buffer[len++] = (uint8_t)id;
+	buffer[len++] = (uint8_t)(id >> 8);
+	for (uint32_t shift = 0; shift < 32; shift += 8)
+	{
+		buffer[len++] = (uint8_t)(timestamp >> shift);
+	}
+	for (uint16_t i = 0; i < arg_count; ++i)
+	{
+		for (uint32_t shift = 0; shift < 32; shift += 8)
+		{
+			buffer[len++] = (uint8_t)(args[i] >> shift);
+		}
+	}
+
+	uint8_t checksum = 0;
+	for (uint32_t i = 2; i < len; ++i)
+	{
+		checksum += buffer[i];
+	}
+
+	buffer[0] = BINLOG_SYNC;
+	buffer[1] = (uint8_t)(len - 2);
+	buffer[len++] = checksum;
+
+	output(buffer, len);
+}
+
+uint32_t binlog_flush(binlog_t* log, binlog_output_t output, uint32_t max_records)
+{
+	uint32_t sent = 0;
+
+	const uint32_t lost = (uint32_t)atomic_exchange_explicit(&log->lost, 0, memory_order_relaxed);
+	if (lost > 0)
+	{
+		binlog_send(output, BINLOG_ID_LOST, (log->timestamp != NULL) ? log->timestamp() : 0, 1, &lost);
+	}
+
+	uint_fast32_t tail = atomic_load_explicit(&log->tail, memory_order_relaxed);
+
+	while (sent < max_records)
+	{
+		binlog_record_t* record = &log->records[tail & log->mask];
+
+		// Not reserved, or reserved but not committed yet
+		if (atomic_load_explicit(&record->sequence, memory_order_acquire) != (uint_fast32_t)(tail + 1)) break;
+
+		const uint16_t id = record->id;
+		const uint32_t timestamp = record->timestamp;
+		const uint16_t arg_count = record->arg_count;
+		uint32_t args[BINLOG_MAX_ARGS];
+		memcpy(args, record->args, sizeof(args));
+
+		// The record can be reused by the producers
+		tail++;
+		atomic_store_explicit(&log->tail, tail, memory_order_release);
+
+		binlog_send(output, id, timestamp, arg_count, args);
+		sent++;
+	}
+
+	return sent;
+}
@@ -0,0 +1,134 @@
+/*
+ * binlog.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ * Deferred binary logging: events are stored as (message id, timestamp, raw arguments) in a ring,
+ * formatted and sent later by a low priority context, decoded on the host (see src/python/binlog_decode.py)
+ *
+ * Rutronik Elektronische Bauelemente GmbH Disclaimer: The evaluation board
+ * including the software is for testing purposes only and,
+ * because it has limited functions and limited resilience, is not suitable
+ * for permanent use under real conditions. If the evaluation board is
+ * nevertheless used under real conditions, this is done at one’s responsibility;
+ * any liability of Rutronik is insofar excluded
+ */
+
+#ifndef BINLOG_H_
+#define BINLOG_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdatomic.h>
+
+/**
+ * Maximum number of 32 bits arguments of a message
+ */
+#define BINLOG_MAX_ARGS 4U
+
+/**
+ * Messages are declared by the application with an X macro, the decoder reads the format strings from the source:
+ *
+ * #define APP_LOG_MESSAGES(X) \
+ * 	X(LOG_FRAME_DROPPED, 1, "frames dropped: %u") \
+ * 	X(LOG_TARGET, 2, "target %f;%f")
+ *
+ * enum { APP_LOG_MESSAGES(BINLOG_ENUM) };
+ *
+ * Arguments are the raw 32 bits words: integers as is, floats with binlog_float.
+ * Id 0 is reserved (events lost because the ring was full).
+ */
+#define BINLOG_ENUM(name, id, format) name = id,
+
+#define BINLOG_ID_LOST 0U
+
+/**
+ * Marker of the beginning of a record on the output stream
+ */
+#define BINLOG_SYNC 0xA5U
+
+typedef struct
+{
+	atomic_uint_fast32_t sequence;	/**< Reservation index + 1 once the record is written (commit marker) */
+	uint32_t timestamp;
+	uint16_t id;
+	uint16_t arg_count;
+	uint32_t args[BINLOG_MAX_ARGS];
+} binlog_record_t;
+
+/**
+ * @brief Output of binlog_flush (e.g. UART write)
+ */
+typedef void (*binlog_output_t)(const uint8_t* data, uint32_t len);
+
+/**
+ * Ring of records
+ *
+ * Several producers (interrupts, tasks) can write at the same time: a record is reserved with a compare and swap on head
+ * (no lock, no interrupt masking), then committed with its sequence. A single consumer (binlog_flush) reads the committed records.
+ */
+typedef struct
+{
+	binlog_record_t* records;
+	uint32_t mask;					/**< Record count - 1 (power of two) */
+	uint32_t (*timestamp)(void);	/**< Time source of the records (or NULL) */
+
+	atomic_uint_fast32_t head;		/**< Records reserved by the producers */
+	atomic_uint_fast32_t tail;		/**< Records read by the consumer */
+	atomic_uint_fast32_t lost;		/**< Records dropped since the last flush (ring full) */
+} binlog_t;
+
+/**
+ * @brief Initialize a log
+ *
+ * @param [out] log	Log to initialize
+ * @param [in] records	Ring. Size of this buffer should be record_count records
+ * @param [in] record_count	Number of records, power of two
+ * @param [in] timestamp	Time source called for each record (or NULL -> timestamp 0)
+ *
+ * @retval 0 	Success
+ * @retval != 0	Error occurred
+ */
+int32_t binlog_init(binlog_t* log, binlog_record_t* records, uint32_t record_count, uint32_t (*timestamp)(void));
+
+/**
+ * @brief Store a message (interrupt safe, no formatting)
+ *
+ * When the ring is full, the message is dropped and counted (reported by binlog_flush with the id BINLOG_ID_LOST).
+ *
+ * @param [in] log	Log
+ * @param [in] id	Message id
+ * @param [in] arg_count	Number of arguments, [0] to [BINLOG_MAX_ARGS]
+ * @param [in] a0..a3	Arguments (the ones after arg_count are ignored)
+ *
+ * @retval true	Message stored
+ * @retval false	Ring full, message dropped
+ */
+bool binlog_write(binlog_t* log, uint16_t id, uint16_t arg_count, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3);
+
+/**
+ * @brief Raw bits of a float argument
+ */
+static inline uint32_t binlog_float(float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+/**
+ * @brief Send up to max_records committed records to output (single consumer, call from a low priority context)
+ *
+ * Each record is sent as: BINLOG_SYNC, length of the payload, payload (id (u16), timestamp (u32), arguments (u32 each)),
+ * checksum (sum of the payload bytes modulo 256). Little endian.
+ *
+ * @param [in] log	Log
+ * @param [in] output	Output of the encoded records
+ * @param [in] max_records	Maximum number of records sent (bounds the time spent in the function)
+ *
+ * @retval Number of records sent
+ */
+uint32_t binlog_flush(binlog_t* log, binlog_output_t output, uint32_t max_records);
+
+#endif /* BINLOG_H_ */
@@ -0,0 +1,305 @@
+/*
+ * cfar.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ * Rutronik Elektronische Bauelemente GmbH Disclaimer: The evaluation board
+ * including the software is for testing purposes only and,
+ * because it has limited functions and limited resilience, is not suitable
+ * for permanent use under real conditions. If the evaluation board is
+ * nevertheless used under real conditions, this is done at one’s responsibility;
+ * any liability of Rutronik is insofar excluded
+ */
+
+#include "cfar.h"
+
+#include <float.h>
+
+int32_t cfar_config_check(const cfar_config_t* config, uint16_t velocity_count)
+{
+	if (config == NULL) return -1;
+
+	if (config->mode == CFAR_MODE_OS)
+	{
+		if (config->training_bins == 0) return IFX_SENSOR_DSP_ARGUMENT_ERROR;
+		return IFX_SENSOR_DSP_STATUS_OK;
+	}
+
+	if ((config->training_bins == 0) && (config->training_velocities == 0)) return IFX_SENSOR_DSP_ARGUMENT_ERROR;
+	if ((2U * (config->guard_velocities + config->training_velocities) + 1U) > velocity_count) return IFX_SENSOR_DSP_ARGUMENT_ERROR;
+
+	return IFX_SENSOR_DSP_STATUS_OK;
+}
+
+uint32_t cfar_work_len(const cfar_config_t* config, uint16_t velocity_count)
+{
+	if (config->mode == CFAR_MODE_OS)
+	{
+		return 2U * config->training_bins;
+	}
+
+	return 2U * velocity_count;
+}
+
+/**
+ * @brief Add (sign = 1) or remove (sign = -1) one row of the map to / from the column sums
+ */
+static void cfar_column_update(const float32_t* row, uint16_t len, float32_t* column_sum, float32_t sign)
+{
+	for (uint16_t v = 0; v < len; ++v)
+	{
+		column_sum[v] += sign * row[v];
+	}
+}
+
+/**
+ * @brief Sum of values[(v + len) mod len] for v in [-half, half] (window centered on 0, 2 * half + 1 <= len)
+ */
+static float32_t cfar_window_sum(const float32_t* values, uint16_t len, uint16_t half)
+{
+	float32_t sum = values[0];
+	for (uint16_t d = 1; d <= half; ++d)
+	{
+		sum += values[d] + values[len - d];
+	}
+	return sum;
+}
+
+static bool cfar_is_local_maximum(const float32_t* power, uint16_t bin_count, uint16_t velocity_count, uint16_t bin, uint16_t velocity)
+{
+	const float32_t value = power[bin * velocity_count + velocity];
+
+	for (int32_t db = -1; db <= 1; ++db)
+	{
+		const int32_t row = (int32_t)bin + db;
+		if ((row < 0) || (row >= bin_count)) continue;
+
+		for (int32_t dv = -1; dv <= 1; ++dv)
+		{
+			if ((db == 0) && (dv == 0)) continue;
+
+			const uint16_t column = (uint16_t)((velocity + velocity_count + dv) % velocity_count);
+			if (power[row * velocity_count + column] > value) return false;
+		}
+	}
+
+	return true;
+}
+
+void cfar_detection_insert(cfar_detection_t* detections, uint16_t max_detections, uint16_t* detection_count,
+		uint16_t bin, uint16_t velocity, float32_t power, float32_t noise)
+{
+	if (max_detections == 0) return;
+
+	uint16_t pos = *detection_count;
+	if (pos == max_detections)
+	{
+		if (power <= detections[max_detections - 1].power) return;
+		pos = max_detections - 1;
+	}
+	else
+	{
+		(*detection_count)++;
+	}
+
+	while ((pos > 0) && (detections[pos - 1].power < power))
+	{
+		detections[pos] = detections[pos - 1];
+		pos--;
+	}
+
+	detections[pos].bin = bin;
+	detections[pos].velocity = velocity;
+	detections[pos].power = power;
+	detections[pos].snr = 10.f * log10f(power / ((noise > FLT_MIN) ? noise : FLT_MIN));
+}
+
+float32_t cfar_select(float32_t* buffer, uint16_t len, uint16_t k)
+{
+	uint16_t left = 0;
+	uint16_t right = len - 1;
+
+	while (left < right)
+	{
+		const float32_t pivot = buffer[(left + right) / 2];
+		uint16_t i = left;
+		uint16_t j = right;
+
+		while (i <= j)
+		{
+			while (buffer[i] < pivot) i++;
+			while (buffer[j] > pivot) j--;
+			if (i <= j)
+			{
+				const float32_t tmp = buffer[i];
+				buffer[i] = buffer[j];
+				buffer[j] = tmp;
+				i++;
+				if (j == 0) break;
+				j--;
+			}
+		}
+
+		if (k <= j) right = j;
+		else if (k >= i) left = i;
+		else break;
+	}
+
+	return buffer[k];
+}
+
+static void cfar_ca(const cfar_config_t* config,
+		const float32_t* power,
+		uint16_t bin_count,
+		uint16_t velocity_count,
+		float32_t* work,
+		cfar_detection_t* detections,
+		uint16_t max_detections,
+		uint16_t* detection_count)
+{
+	const int32_t outer_bins = config->guard_bins + config->training_bins;
+	const int32_t inner_bins = config->guard_bins;
+	const uint16_t outer_velocities = config->guard_velocities + config->training_velocities;
+	const uint16_t inner_velocities = config->guard_velocities;
+
+	// Sums, for each Doppler bin, of the rows contained in the range windows (updated when moving to the next bin)
+	float32_t* outer = work;
+	float32_t* inner = &work[velocity_count];
+	memset(work, 0, 2U * velocity_count * sizeof(float32_t));
+
+	for (int32_t row = 0; (row <= outer_bins) && (row < bin_count); ++row)
+	{
+		cfar_column_update(&power[row * velocity_count], velocity_count, outer, 1.f);
+	}
+	for (int32_t row = 0; (row <= inner_bins) && (row < bin_count); ++row)
+	{
+		cfar_column_update(&power[row * velocity_count], velocity_count, inner, 1.f);
+	}
+
+	for (int32_t bin = 0; bin < bin_count; ++bin)
+	{
+		if (bin > 0)
+		{
+			// Slide the range windows by one row
+			const int32_t outer_in = bin + outer_bins;
+			const int32_t outer_out = bin - outer_bins - 1;
+			const int32_t inner_in = bin + inner_bins;
+			const int32_t inner_out = bin - inner_bins - 1;
+
+			if (outer_in < bin_count) cfar_column_update(&power[outer_in * velocity_count], velocity_count, outer, 1.f);
+			if (outer_out >= 0) cfar_column_update(&power[outer_out * velocity_count], velocity_count, outer, -1.f);
+			if (inner_in < bin_count) cfar_column_update(&power[inner_in * velocity_count], velocity_count, inner, 1.f);
+			if (inner_out >= 0) cfar_column_update(&power[inner_out * velocity_count], velocity_count, inner, -1.f);
+		}
+
+		// Number of training cells (the range window is cut at the edges of the map)
+		const int32_t outer_rows = ((bin + outer_bins < bin_count) ? (bin + outer_bins) : (bin_count - 1)) - ((bin - outer_bins > 0) ? (bin - outer_bins) : 0) + 1;
+		const int32_t inner_rows = ((bin + inner_bins < bin_count) ? (bin + inner_bins) : (bin_count - 1)) - ((bin - inner_bins > 0) ? (bin - inner_bins) : 0) + 1;
+		const int32_t training_count = outer_rows * (2 * outer_velocities + 1) - inner_rows * (2 * inner_velocities + 1);
+		if (training_count <= 0) continue;
+
+		const float32_t scale = 1.f / (float32_t)training_count;
+		const float32_t* row = &power[bin * velocity_count];
+
+		// Doppler windows (circular) slid along the row: indexes of the values entering / leaving them
+		float32_t outer_sum = cfar_window_sum(outer, velocity_count, outer_velocities);
+		float32_t inner_sum = cfar_window_sum(inner, velocity_count, inner_velocities);
+		uint16_t outer_add = outer_velocities + 1U;
+		uint16_t outer_remove = velocity_count - outer_velocities;
+		uint16_t inner_add = inner_velocities + 1U;
+		uint16_t inner_remove = velocity_count - inner_velocities;
+		if (outer_add >= velocity_count) outer_add = 0;
+		if (outer_remove >= velocity_count) outer_remove = 0;
+		if (inner_add >= velocity_count) inner_add = 0;
+		if (inner_remove >= velocity_count) inner_remove = 0;
+
+		for (uint16_t velocity = 0; velocity < velocity_count; ++velocity)
+		{
+			float32_t noise = (outer_sum - inner_sum) * scale;
+			if (noise < 0) noise = 0;	// Rounding of the running sums
+
+			outer_sum += outer[outer_add] - outer[outer_remove];
+			inner_sum += inner[inner_add] - inner[inner_remove];
+			if (++outer_add == velocity_count) outer_add = 0;
+			if (++outer_remove == velocity_count) outer_remove = 0;
+			if (++inner_add == velocity_count) inner_add = 0;
+			if (++inner_remove == velocity_count) inner_remove = 0;
+
+			if (row[velocity] <= config->threshold_factor * noise) continue;
+			if (config->local_maximum && !cfar_is_local_maximum(power, bin_count, velocity_count, bin, velocity)) continue;
+
+			cfar_detection_insert(detections, max_detections, detection_count, bin, velocity, row[velocity], noise);
+		}
+	}
+}
+
+static void cfar_os(const cfar_config_t* config,
+		const float32_t* power,
+		uint16_t bin_count,
+		uint16_t velocity_count,
+		float32_t* work,
+		cfar_detection_t* detections,
+		uint16_t max_detections,
+		uint16_t* detection_count)
+{
+	const int32_t outer_bins = config->guard_bins + config->training_bins;
+	const int32_t inner_bins = config->guard_bins;
+
+	for (int32_t bin = 0; bin < bin_count; ++bin)
+	{
+		for (uint16_t velocity = 0; velocity < velocity_count; ++velocity)
+		{
+			// Training cells before and after the guard cells (same Doppler bin)
+			uint16_t count = 0;
+			for (int32_t row = bin - outer_bins; row <= bin + outer_bins; ++row)
+			{
+				if ((row < 0) || (row >= bin_count)) continue;
+				if ((row >= bin - inner_bins) && (row <= bin + inner_bins)) continue;
+				work[count++] = power[row * velocity_count + velocity];
+			}
+			if (count == 0) continue;
+
+			// Rank scaled to the number of cells available at the edges
+			uint16_t rank = (uint16_t)(((uint32_t)config->os_rank * count) / (2U * config->training_bins));
+			if (rank >= count) rank = count - 1;
+
+			const float32_t value = power[bin * velocity_count + velocity];
+			const float32_t noise = cfar_select(work, count, rank);
+
+			if (value <= config->threshold_factor * noise) continue;
+			if (config->local_maximum && !cfar_is_local_maximum(power, bin_count, velocity_count, bin, velocity)) continue;
+
+			cfar_detection_insert(detections, max_detections, detection_count, bin, velocity, value, noise);
+		}
+	}
+}
+
+int32_t cfar_do(const cfar_config_t* config,
+		const float32_t* power,
+		uint16_t bin_count,
+		uint16_t velocity_count,
+		float32_t* work,
+		cfar_detection_t* detections,
+		uint16_t max_detections,
+		uint16_t* detection_count)
+{
+	if ((config == NULL) || (power == NULL) || (work == NULL)) return -1;
+	if ((detections == NULL) || (detection_count == NULL)) return -2;
+
+	*detection_count = 0;
+	if ((bin_count == 0) || (velocity_count == 0)) return IFX_SENSOR_DSP_STATUS_OK;
+
+	const int32_t retval = cfar_config_check(config, velocity_count);
+	if (retval != IFX_SENSOR_DSP_STATUS_OK) return retval;
+
+	if (config->mode == CFAR_MODE_OS)
+	{
+		cfar_os(config, power, bin_count, velocity_count, work, detections, max_detections, detection_count);
+	}
+	else
+	{
+		cfar_ca(config, power, bin_count, velocity_count, work, detections, max_detections, detection_count);
+	}
+
+	return IFX_SENSOR_DSP_STATUS_OK;
+}
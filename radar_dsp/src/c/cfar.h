@@ -0,0 +1,120 @@
+/*
+ * cfar.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ * Constant false alarm rate (CFAR) detection on a range-Doppler power map
+ *
+ * Rutronik Elektronische Bauelemente GmbH Disclaimer: The evaluation board
+ * including the software is for testing purposes only and,
+ * because it has limited functions and limited resilience, is not suitable
+ * for permanent use under real conditions. If the evaluation board is
+ * nevertheless used under real conditions, this is done at one’s responsibility;
+ * any liability of Rutronik is insofar excluded
+ */
+
+#ifndef CFAR_H_
+#define CFAR_H_
+
+#include "ifx_sensor_dsp.h"
+
+/**
+ * Noise estimation of the cell under test
+ */
+typedef enum
+{
+	CFAR_MODE_CA = 0,	/**< Cell averaging: mean of the training cells (2D window: range x Doppler) */
+	CFAR_MODE_OS,		/**< Ordered statistic: os_rank-th smallest training cell (1D window along the range axis) */
+} cfar_mode_t;
+
+typedef struct
+{
+	cfar_mode_t mode;
+	uint8_t guard_bins;				/**< Guard cells on each side of the cell under test (range axis) */
+	uint8_t training_bins;			/**< Training cells after the guard cells on each side (range axis) */
+	uint8_t guard_velocities;		/**< Guard cells on each side of the cell under test (Doppler axis, CA only) */
+	uint8_t training_velocities;	/**< Training cells after the guard cells on each side (Doppler axis, CA only) */
+	float32_t threshold_factor;		/**< Detection if power > threshold_factor * noise (power ratio, not dB) */
+	uint8_t os_rank;				/**< OS only: rank of the noise estimate among the 2 * training_bins cells (0 -> smallest) */
+	bool local_maximum;				/**< Only report cells that are the maximum of their 3x3 neighbourhood (one detection per target) */
+} cfar_config_t;
+
+/**
+ * Default configuration: CA-CFAR, 2 x 4 training cells per axis, 12 (10.8 dB) above the noise
+ */
+#define CFAR_CONFIG_DEFAULT { CFAR_MODE_CA, 1, 4, 1, 4, 12.0f, 0, true }
+
+typedef struct
+{
+	uint16_t bin;			/**< Range bin (row of the map) */
+	uint16_t velocity;		/**< Doppler bin (column of the map) */
+	float32_t power;		/**< Magnitude squared of the cell */
+	float32_t snr;			/**< power / noise estimate in dB */
+} cfar_detection_t;
+
+/**
+ * @brief Check the configuration for a map with velocity_count Doppler bins
+ *
+ * @retval 0 	Configuration valid
+ * @retval != 0	No training cell, or Doppler window bigger than the map
+ */
+int32_t cfar_config_check(const cfar_config_t* config, uint16_t velocity_count);
+
+/**
+ * @brief Size of the work buffer needed by cfar_do (in floats)
+ */
+uint32_t cfar_work_len(const cfar_config_t* config, uint16_t velocity_count);
+
+/**
+ * @brief Insert a detection in a list sorted by decreasing power (the weakest is dropped if the list is full)
+ *
+ * @param [in,out] detections	List
+ * @param [in] max_detections	Capacity of detections
+ * @param [in,out] detection_count	Number of detections stored
+ * @param [in] bin	Range bin
+ * @param [in] velocity	Doppler bin
+ * @param [in] power	Power of the cell
+ * @param [in] noise	Noise estimate (power), used for the SNR
+ */
+void cfar_detection_insert(cfar_detection_t* detections, uint16_t max_detections, uint16_t* detection_count,
+		uint16_t bin, uint16_t velocity, float32_t power, float32_t noise);
+
+/**
+ * @brief k-th smallest value of buffer (quickselect, used for the ordered statistic noise estimate)
+ *
+ * @param [in,out] buffer	Values, reordered by the function
+ * @param [in] len	Number of values (> 0)
+ * @param [in] k	Rank, [0] to [len - 1]
+ */
+float32_t cfar_select(float32_t* buffer, uint16_t len, uint16_t k);
+
+/**
+ * @brief Run the CFAR detector on a power map
+ *
+ * CA: the sums of the training cells are updated with running windows (rows entering / leaving the range window,
+ * sliding sums along the Doppler axis), so the cost is O(cells) whatever the window size.
+ * OS: the training cells of each cell are partially sorted, cost is O(cells x 2 * training_bins).
+ * The Doppler axis is circular (FFT output), the range axis is not: close to the edges, fewer training cells are used.
+ *
+ * @param [in] config	CFAR configuration
+ * @param [in] power	Power map (magnitude squared), bin major: power[bin * velocity_count + velocity]
+ * @param [in] bin_count	Number of range bins of the map
+ * @param [in] velocity_count	Number of Doppler bins of the map
+ * @param [in] work		Work buffer. Size of this buffer should be cfar_work_len(config, velocity_count) floats
+ * @param [out] detections	Detections, sorted by decreasing power. If there are more than max_detections, the strongest are kept
+ * @param [in] max_detections	Capacity of detections
+ * @param [out] detection_count	Number of detections stored
+ *
+ * @retval 0 	Success
+ * @retval != 0	Error occurred
+ */
+int32_t cfar_do(const cfar_config_t* config,
+		const float32_t* power,
+		uint16_t bin_count,
+		uint16_t velocity_count,
+		float32_t* work,
+		cfar_detection_t* detections,
+		uint16_t max_detections,
+		uint16_t* detection_count);
+
+#endif /* CFAR_H_ */
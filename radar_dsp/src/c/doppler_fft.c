@@ -14,32 +14,53 @@
 
 #include "doppler_fft.h"
 
-int32_t doppler_fft_bin_do(cfloat32_t* range,
+int32_t doppler_fft_ctx_init(doppler_fft_ctx_t* ctx, uint16_t num_chirps_per_frame, range_fft_layout_t layout)
+{
+	if (ctx == NULL) return -1;
+
+	if (arm_cfft_init_f32(&ctx->cfft, num_chirps_per_frame) != ARM_MATH_SUCCESS)
+	{
+		return IFX_SENSOR_DSP_ARGUMENT_ERROR;
+	}
+
+	if (arm_cfft_init_q31(&ctx->cfft_q31, num_chirps_per_frame) != ARM_MATH_SUCCESS)
+	{
+		return IFX_SENSOR_DSP_ARGUMENT_ERROR;
+	}
+
+	ctx->num_chirps_per_frame = num_chirps_per_frame;
+	ctx->layout = layout;
+
+	return IFX_SENSOR_DSP_STATUS_OK;
+}
+
+int32_t doppler_fft_bin_do(const doppler_fft_ctx_t* ctx,
+		cfloat32_t* range,
 		cfloat32_t* doppler,
 		bool mean_removal,
 		const float32_t* win,
 		uint16_t bin_index,
 		uint16_t antenna_index,
-		uint16_t num_chirps_per_frame,
 		uint16_t range_fft_len)
 {
-    if (range == NULL) return -1;
+    if ((ctx == NULL) || (range == NULL)) return -1;
     if (doppler == NULL) return 2;
 
-    static arm_cfft_instance_f32 cfft = { 0 };
-    if (cfft.fftLen != num_chirps_per_frame)
-    {
-        if (arm_cfft_init_f32(&cfft, num_chirps_per_frame) != ARM_MATH_SUCCESS)
-        {
-            return IFX_SENSOR_DSP_ARGUMENT_ERROR;
-        }
-    }
+    const uint16_t num_chirps_per_frame = ctx->num_chirps_per_frame;
 
     // Construct the source array -> computation of FFT in place
-    const uint16_t start_index = antenna_index * num_chirps_per_frame * range_fft_len;
-    for (uint16_t chirp_idx = 0; chirp_idx < num_chirps_per_frame; ++chirp_idx)
+    const uint32_t start_index = (uint32_t)antenna_index * num_chirps_per_frame * range_fft_len;
+    if (ctx->layout == RANGE_FFT_LAYOUT_BIN_MAJOR)
+    {
+    	// The chirps of the bin are contiguous
+    	memcpy(doppler, &range[start_index + (uint32_t)bin_index * num_chirps_per_frame], num_chirps_per_frame * sizeof(cfloat32_t));
+    }
+    else
     {
-    	doppler[chirp_idx] = range[start_index + chirp_idx * range_fft_len + bin_index];
+    	for (uint16_t chirp_idx = 0; chirp_idx < num_chirps_per_frame; ++chirp_idx)
+    	{
+    		doppler[chirp_idx] = range[start_index + chirp_idx * range_fft_len + bin_index];
+    	}
     }
 
     // Mean removal
@@ -58,9 +79,452 @@ int32_t doppler_fft_bin_do(cfloat32_t* range,
 	}
 
     // Complex FFT
-    arm_cfft_f32(&cfft, (float32_t*)doppler, 0, 1);
+    arm_cfft_f32(&ctx->cfft, (float32_t*)doppler, 0, 1);
 
     // Remark: to be correct, we should shift the buffer, to center the 0 frequency
 
     return IFX_SENSOR_DSP_STATUS_OK;
 }
+
+int32_t doppler_fft_cell_do(const doppler_fft_ctx_t* ctx,
+		const cfloat32_t* range_bin,
+		cfloat32_t* cell,
+		bool mean_removal,
+		const float32_t* win,
+		uint16_t velocity_index)
+{
+    if ((ctx == NULL) || (range_bin == NULL)) return -1;
+    if (cell == NULL) return 2;
+
+    const uint16_t num_chirps_per_frame = ctx->num_chirps_per_frame;
+    if (velocity_index >= num_chirps_per_frame) return IFX_SENSOR_DSP_ARGUMENT_ERROR;
+
+    float32_t mean_real = 0;
+    float32_t mean_imag = 0;
+    if (mean_removal)
+    {
+    	for (uint16_t chirp_idx = 0; chirp_idx < num_chirps_per_frame; ++chirp_idx)
+    	{
+    		mean_real += CREAL_F32(range_bin[chirp_idx]);
+    		mean_imag += CIMAG_F32(range_bin[chirp_idx]);
+    	}
+    	mean_real /= (float32_t)num_chirps_per_frame;
+    	mean_imag /= (float32_t)num_chirps_per_frame;
+    }
+
+    // Goertzel on the real and on the imaginary part (the DFT is linear)
+    const float32_t w = 2.0f * (float32_t)M_PI * (float32_t)velocity_index / (float32_t)num_chirps_per_frame;
+    const float32_t cos_w = cosf(w);
+    const float32_t sin_w = sinf(w);
+    const float32_t k = 2.0f * cos_w;
+    float32_t s1_real = 0, s2_real = 0;
+    float32_t s1_imag = 0, s2_imag = 0;
+
+    for (uint16_t chirp_idx = 0; chirp_idx < num_chirps_per_frame; ++chirp_idx)
+    {
+    	float32_t x_real = CREAL_F32(range_bin[chirp_idx]) - mean_real;
+    	float32_t x_imag = CIMAG_F32(range_bin[chirp_idx]) - mean_imag;
+    	if (win != NULL)
+    	{
+    		x_real *= win[chirp_idx];
+    		x_imag *= win[chirp_idx];
+    	}
+
+    	const float32_t s0_real = x_real + k * s1_real - s2_real;
+    	s2_real = s1_real;
+    	s1_real = s0_real;
+
+    	const float32_t s0_imag = x_imag + k * s1_imag - s2_imag;
+    	s2_imag = s1_imag;
+    	s1_imag = s0_imag;
+    }
+
+    // X = e^(i.w) * s[len - 1] - s[len - 2], for each part: X = X_real_part + i.X_imag_part
+    const float32_t xr_real = cos_w * s1_real - s2_real;
+    const float32_t xr_imag = sin_w * s1_real;
+    const float32_t xi_real = cos_w * s1_imag - s2_imag;
+    const float32_t xi_imag = sin_w * s1_imag;
+
+    CREAL_F32(*cell) = xr_real - xi_imag;
+    CIMAG_F32(*cell) = xr_imag + xi_real;
+
+    return IFX_SENSOR_DSP_STATUS_OK;
+}
+
+int32_t doppler_fft_map_do(const doppler_fft_ctx_t* ctx,
+		cfloat32_t* range,
+		cfloat32_t* map,
+		bool mean_removal,
+		const float32_t* win,
+		uint8_t antenna_count,
+		uint8_t antenna_mask,
+		uint16_t range_fft_len,
+		const bool* bin_enabled)
+{
+    if ((ctx == NULL) || (range == NULL)) return -1;
+    if (map == NULL) return 2;
+
+    const uint16_t num_chirps_per_frame = ctx->num_chirps_per_frame;
+    const bool bin_major = (ctx->layout == RANGE_FFT_LAYOUT_BIN_MAJOR);
+    const uint32_t chirp_stride = bin_major ? 1U : range_fft_len;
+    const uint32_t bin_stride = bin_major ? num_chirps_per_frame : 1U;
+
+    for (uint8_t antenna_idx = 0; antenna_idx < antenna_count; ++antenna_idx)
+    {
+    	if (((1 << antenna_idx) & antenna_mask) == 0) continue;
+
+    	const uint32_t antenna_offset = (uint32_t)antenna_idx * num_chirps_per_frame * range_fft_len;
+
+    	for (uint16_t bin_idx = 0; bin_idx < range_fft_len; ++bin_idx)
+    	{
+    		const float32_t* source = (const float32_t*)&range[antenna_offset + bin_idx * bin_stride];
+    		float32_t* doppler = (float32_t*)&map[antenna_offset + (uint32_t)bin_idx * num_chirps_per_frame];
+
+    		if ((bin_enabled != NULL) && !bin_enabled[bin_idx])
+    		{
+    			memset(doppler, 0, num_chirps_per_frame * sizeof(cfloat32_t));
+    			continue;
+    		}
+
+    		// Gather and sum
+    		float32_t sum_real = 0;
+    		float32_t sum_imag = 0;
+    		for (uint16_t chirp_idx = 0; chirp_idx < num_chirps_per_frame; ++chirp_idx)
+    		{
+    			const float32_t real = source[2U * chirp_idx * chirp_stride];
+    			const float32_t imag = source[2U * chirp_idx * chirp_stride + 1U];
+    			doppler[2 * chirp_idx] = real;
+    			doppler[2 * chirp_idx + 1] = imag;
+    			sum_real += real;
+    			sum_imag += imag;
+    		}
+
+    		// Mean removal and windowing in one pass
+    		float32_t mean_real = 0;
+    		float32_t mean_imag = 0;
+    		if (mean_removal)
+    		{
+    			mean_real = sum_real / (float32_t)num_chirps_per_frame;
+    			mean_imag = sum_imag / (float32_t)num_chirps_per_frame;
+    		}
+
+    		if (win != NULL)
+    		{
+    			for (uint16_t chirp_idx = 0; chirp_idx < num_chirps_per_frame; ++chirp_idx)
+    			{
+    				doppler[2 * chirp_idx] = (doppler[2 * chirp_idx] - mean_real) * win[chirp_idx];
+    				doppler[2 * chirp_idx + 1] = (doppler[2 * chirp_idx + 1] - mean_imag) * win[chirp_idx];
+    			}
+    		}
+    		else if (mean_removal)
+    		{
+    			for (uint16_t chirp_idx = 0; chirp_idx < num_chirps_per_frame; ++chirp_idx)
+    			{
+    				doppler[2 * chirp_idx] -= mean_real;
+    				doppler[2 * chirp_idx + 1] -= mean_imag;
+    			}
+    		}
+
+    		// Complex FFT (in place)
+    		arm_cfft_f32(&ctx->cfft, doppler, 0, 1);
+    	}
+    }
+
+    return IFX_SENSOR_DSP_STATUS_OK;
+}
+
+int32_t doppler_fft_peak_search(const cfloat32_t* map,
+		uint32_t len,
+		float32_t* work,
+		uint32_t block_len,
+		uint32_t* index,
+		float32_t* magnitude_squared)
+{
+    if ((map == NULL) || (work == NULL)) return -1;
+    if ((index == NULL) || (magnitude_squared == NULL) || (block_len == 0)) return 2;
+
+    float32_t max = 0;
+    uint32_t max_index = 0;
+
+    for (uint32_t block_start = 0; block_start < len; block_start += block_len)
+    {
+    	const uint32_t count = ((len - block_start) < block_len) ? (len - block_start) : block_len;
+
+    	float32_t block_max = 0;
+    	uint32_t block_index = 0;
+    	arm_cmplx_mag_squared_f32((const float32_t*)&map[block_start], work, count);
+    	arm_max_f32(work, count, &block_max, &block_index);
+
+    	// Strictly bigger -> first maximum kept
+    	if (block_max > max)
+    	{
+    		max = block_max;
+    		max_index = block_start + block_index;
+    	}
+    }
+
+    *index = max_index;
+    *magnitude_squared = max;
+
+    return IFX_SENSOR_DSP_STATUS_OK;
+}
+
+void doppler_fft_window_q31_init(q31_t* win_table, const float32_t* win, uint16_t num_chirps_per_frame)
+{
+	for(uint16_t i = 0; i < num_chirps_per_frame; ++i)
+	{
+		float64_t value = (float64_t)win[i] * 2147483648.0;
+		if (value > 2147483647.0) value = 2147483647.0;
+		if (value < -2147483648.0) value = -2147483648.0;
+		win_table[i] = (q31_t)value;
+	}
+}
+
+/**
+ * Q15 range values are moved to Q31 with DOPPLER_FFT_Q31_INPUT_SHIFT,
+ * which leaves enough headroom for the mean removal
+ */
+#define DOPPLER_FFT_Q31_INPUT_SHIFT 14
+
+int32_t doppler_fft_bin_q31_do(const doppler_fft_ctx_t* ctx,
+		const q15_t* range,
+		const int8_t* range_exponent,
+		cfloat32_t* doppler,
+		q31_t* work,
+		bool mean_removal,
+		const q31_t* win,
+		uint16_t bin_index,
+		uint16_t antenna_index,
+		uint16_t range_fft_len)
+{
+    if ((ctx == NULL) || (range == NULL) || (range_exponent == NULL)) return -1;
+    if ((doppler == NULL) || (work == NULL)) return 2;
+
+    const uint16_t num_chirps_per_frame = ctx->num_chirps_per_frame;
+
+    // Common exponent of the bin
+    const int8_t* exponent = &range_exponent[antenna_index * num_chirps_per_frame];
+    int8_t common_exponent = exponent[0];
+    for (uint16_t chirp_idx = 1; chirp_idx < num_chirps_per_frame; ++chirp_idx)
+    {
+    	if (exponent[chirp_idx] > common_exponent) common_exponent = exponent[chirp_idx];
+    }
+
+    // Construct the source array (aligned on the common exponent)
+    const q15_t* source = &range[2U * antenna_index * num_chirps_per_frame * range_fft_len];
+    uint32_t chirp_stride = 2U * range_fft_len;
+    if (ctx->layout == RANGE_FFT_LAYOUT_BIN_MAJOR)
+    {
+    	// The chirps of the bin are contiguous
+    	source += 2U * bin_index * num_chirps_per_frame;
+    	chirp_stride = 2U;
+    }
+    else
+    {
+    	source += 2U * bin_index;
+    }
+
+    int64_t sum_real = 0;
+    int64_t sum_imag = 0;
+    for (uint16_t chirp_idx = 0; chirp_idx < num_chirps_per_frame; ++chirp_idx)
+    {
+    	const q15_t* value = &source[chirp_idx * chirp_stride];
+    	const int8_t shift = common_exponent - exponent[chirp_idx];
+    	if (shift >= 31)
+    	{
+    		work[2 * chirp_idx] = 0;
+    		work[2 * chirp_idx + 1] = 0;
+    	}
+    	else
+    	{
+    		work[2 * chirp_idx] = ((q31_t)value[0] * (1 << DOPPLER_FFT_Q31_INPUT_SHIFT)) >> shift;
+    		work[2 * chirp_idx + 1] = ((q31_t)value[1] * (1 << DOPPLER_FFT_Q31_INPUT_SHIFT)) >> shift;
+    	}
+    	sum_real += work[2 * chirp_idx];
+    	sum_imag += work[2 * chirp_idx + 1];
+    }
+
+    // Mean removal
+    if (mean_removal)
+	{
+    	const q31_t mean_real = (q31_t)(sum_real / num_chirps_per_frame);
+    	const q31_t mean_imag = (q31_t)(sum_imag / num_chirps_per_frame);
+    	for (uint16_t chirp_idx = 0; chirp_idx < num_chirps_per_frame; ++chirp_idx)
+    	{
+    		work[2 * chirp_idx] -= mean_real;
+    		work[2 * chirp_idx + 1] -= mean_imag;
+    	}
+	}
+
+    // Windowing
+    if (win != NULL)
+	{
+    	for (uint16_t chirp_idx = 0; chirp_idx < num_chirps_per_frame; ++chirp_idx)
+    	{
+    		work[2 * chirp_idx] = (q31_t)(((int64_t)work[2 * chirp_idx] * win[chirp_idx]) >> 31);
+    		work[2 * chirp_idx + 1] = (q31_t)(((int64_t)work[2 * chirp_idx + 1] * win[chirp_idx]) >> 31);
+    	}
+	}
+
+    // Block floating point: normalize to use the full Q31 range
+    q31_t max = 0;
+    for (uint32_t i = 0; i < 2U * num_chirps_per_frame; ++i)
+    {
+    	q31_t value = (work[i] < 0) ? -work[i] : work[i];
+    	if (value > max) max = value;
+    }
+
+    int8_t shift = 0;
+    while ((max != 0) && (max < 0x40000000))
+    {
+    	max <<= 1;
+    	shift++;
+    }
+    if (shift != 0)
+    {
+    	for (uint32_t i = 0; i < 2U * num_chirps_per_frame; ++i) work[i] = (q31_t)((uint32_t)work[i] << shift);
+    }
+
+    // Complex FFT (output downscaled by num_chirps_per_frame)
+    arm_cfft_q31(&ctx->cfft_q31, work, 0, 1);
+
+    int8_t fft_exponent = 0;
+    while ((1U << fft_exponent) < num_chirps_per_frame) fft_exponent++;
+
+    // Back to float
+    const int32_t exponent_out = fft_exponent + common_exponent - DOPPLER_FFT_Q31_INPUT_SHIFT - shift;
+    for (uint16_t chirp_idx = 0; chirp_idx < num_chirps_per_frame; ++chirp_idx)
+    {
+    	CREAL_F32(doppler[chirp_idx]) = ldexpf((float32_t)work[2 * chirp_idx], exponent_out);
+    	CIMAG_F32(doppler[chirp_idx]) = ldexpf((float32_t)work[2 * chirp_idx + 1], exponent_out);
+    }
+
+    return IFX_SENSOR_DSP_STATUS_OK;
+}
+
+int32_t doppler_fft_map_q31_do(const doppler_fft_ctx_t* ctx,
+		const q15_t* range,
+		const int8_t* range_exponent,
+		cfloat32_t* map,
+		q31_t* work,
+		bool mean_removal,
+		const q31_t* win,
+		uint8_t antenna_count,
+		uint8_t antenna_mask,
+		uint16_t range_fft_len,
+		const bool* bin_enabled)
+{
+    if ((ctx == NULL) || (range == NULL) || (range_exponent == NULL)) return -1;
+    if ((map == NULL) || (work == NULL)) return 2;
+
+    const uint16_t num_chirps_per_frame = ctx->num_chirps_per_frame;
+
+    for (uint8_t antenna_idx = 0; antenna_idx < antenna_count; ++antenna_idx)
+    {
+    	if (((1 << antenna_idx) & antenna_mask) == 0) continue;
+
+    	for (uint16_t bin_idx = 0; bin_idx < range_fft_len; ++bin_idx)
+    	{
+    		cfloat32_t* doppler = &map[((uint32_t)antenna_idx * range_fft_len + bin_idx) * num_chirps_per_frame];
+
+    		if ((bin_enabled != NULL) && !bin_enabled[bin_idx])
+    		{
+    			memset(doppler, 0, num_chirps_per_frame * sizeof(cfloat32_t));
+    			continue;
+    		}
+
+    		const int32_t retval = doppler_fft_bin_q31_do(ctx, range, range_exponent, doppler, work, mean_removal, win, bin_idx, antenna_idx, range_fft_len);
+    		if (retval != IFX_SENSOR_DSP_STATUS_OK) return retval;
+    	}
+    }
+
+    return IFX_SENSOR_DSP_STATUS_OK;
+}
+
+int32_t doppler_fft_energy(const doppler_fft_ctx_t* ctx,
+		const cfloat32_t* range,
+		float32_t* energy,
+		bool mean_removal,
+		uint16_t antenna_index,
+		uint16_t range_fft_len)
+{
+    if ((ctx == NULL) || (range == NULL)) return -1;
+    if (energy == NULL) return 2;
+
+    const uint16_t num_chirps_per_frame = ctx->num_chirps_per_frame;
+    const bool bin_major = (ctx->layout == RANGE_FFT_LAYOUT_BIN_MAJOR);
+    const uint32_t chirp_stride = bin_major ? 1U : range_fft_len;
+    const uint32_t bin_stride = bin_major ? num_chirps_per_frame : 1U;
+    const cfloat32_t* cube = &range[(uint32_t)antenna_index * num_chirps_per_frame * range_fft_len];
+
+    for (uint16_t bin_idx = 0; bin_idx < range_fft_len; ++bin_idx)
+    {
+    	const float32_t* source = (const float32_t*)&cube[bin_idx * bin_stride];
+
+    	float32_t sum_real = 0;
+    	float32_t sum_imag = 0;
+    	float32_t sum_squared = 0;
+    	for (uint16_t chirp_idx = 0; chirp_idx < num_chirps_per_frame; ++chirp_idx)
+    	{
+    		const float32_t real = source[2U * chirp_idx * chirp_stride];
+    		const float32_t imag = source[2U * chirp_idx * chirp_stride + 1U];
+    		sum_real += real;
+    		sum_imag += imag;
+    		sum_squared += real * real + imag * imag;
+    	}
+
+    	// sum |x - mean|^2 = sum |x|^2 - |sum x|^2 / N
+    	if (mean_removal)
+    	{
+    		sum_squared -= (sum_real * sum_real + sum_imag * sum_imag) / (float32_t)num_chirps_per_frame;
+    	}
+    	energy[bin_idx] = (sum_squared > 0) ? sum_squared : 0;
+    }
+
+    return IFX_SENSOR_DSP_STATUS_OK;
+}
+
+int32_t doppler_fft_energy_q15(const doppler_fft_ctx_t* ctx,
+		const q15_t* range,
+		const int8_t* range_exponent,
+		float32_t* energy,
+		bool mean_removal,
+		uint16_t antenna_index,
+		uint16_t range_fft_len)
+{
+    if ((ctx == NULL) || (range == NULL) || (range_exponent == NULL)) return -1;
+    if (energy == NULL) return 2;
+
+    const uint16_t num_chirps_per_frame = ctx->num_chirps_per_frame;
+    const bool bin_major = (ctx->layout == RANGE_FFT_LAYOUT_BIN_MAJOR);
+    const uint32_t chirp_stride = bin_major ? 2U : 2U * range_fft_len;
+    const uint32_t bin_stride = bin_major ? 2U * num_chirps_per_frame : 2U;
+    const q15_t* cube = &range[2U * antenna_index * num_chirps_per_frame * range_fft_len];
+    const int8_t* exponent = &range_exponent[antenna_index * num_chirps_per_frame];
+
+    for (uint16_t bin_idx = 0; bin_idx < range_fft_len; ++bin_idx)
+    {
+    	const q15_t* source = &cube[bin_idx * bin_stride];
+
+    	// Same scale as the float range values (value * 2^exponent of the chirp)
+    	float32_t sum_real = 0;
+    	float32_t sum_imag = 0;
+    	float32_t sum_squared = 0;
+    	for (uint16_t chirp_idx = 0; chirp_idx < num_chirps_per_frame; ++chirp_idx)
+    	{
+    		const float32_t real = ldexpf((float32_t)source[chirp_idx * chirp_stride], exponent[chirp_idx]);
+    		const float32_t imag = ldexpf((float32_t)source[chirp_idx * chirp_stride + 1U], exponent[chirp_idx]);
+    		sum_real += real;
+    		sum_imag += imag;
+    		sum_squared += real * real + imag * imag;
+    	}
+
+    	if (mean_removal)
+    	{
+    		sum_squared -= (sum_real * sum_real + sum_imag * sum_imag) / (float32_t)num_chirps_per_frame;
+    	}
+    	energy[bin_idx] = (sum_squared > 0) ? sum_squared : 0;
+    }
+
+    return IFX_SENSOR_DSP_STATUS_OK;
+}
@@ -16,15 +16,46 @@
 #define PRESENCE_DETECTION_DOPPLER_FFT_H_
 
 #include "ifx_sensor_dsp.h"
+#include "range_fft.h"
+
+/**
+ * Doppler FFT context
+ *
+ * Contains the FFT instances for a given number of chirps per frame.
+ * Created once with doppler_fft_ctx_init and only read by the doppler_fft_* functions.
+ */
+typedef struct
+{
+	arm_cfft_instance_f32 cfft;
+	arm_cfft_instance_q31 cfft_q31;
+	uint16_t num_chirps_per_frame;
+	range_fft_layout_t layout;		/**< Layout of the range cube given to the doppler_fft_* functions */
+} doppler_fft_ctx_t;
+
+/**
+ * @brief Initialize a Doppler FFT context
+ *
+ * @param [out] ctx	Context to initialize
+ * @param [in] num_chirps_per_frame	Number of chirps per frame
+ * @param [in] layout	Layout of the range cube (see range_fft_layout_t).
+ * 						With RANGE_FFT_LAYOUT_BIN_MAJOR, the chirps of a bin are read as one contiguous block
+ *
+ * @retval 0 	Success
+ * @retval != 0	Error occurred
+ */
+int32_t doppler_fft_ctx_init(doppler_fft_ctx_t* ctx, uint16_t num_chirps_per_frame, range_fft_layout_t layout);
 
 /**
  * @brief Compute the Doppler FFT for the given bin (bin_index)
  *
+ * @param [in] ctx		Doppler FFT context (see doppler_fft_ctx_init)
+ *
  * @param [in] range	Array containing the range FFT.
- * 						Size of this buffer is antenna_count * num_chirps_per_frame * (num_samples_per_chirp / 2) * sizeof(cfloat32_t)
+ * 						Size of this buffer is antenna_count * num_chirps_per_frame * range_fft_len * sizeof(cfloat32_t)
+ * 						Layout given by the context (see range_fft_gated_do), with RANGE_FFT_LAYOUT_CHIRP_MAJOR:
  * 						range[0] -> antenna 0, chirp 0, range index 0
  * 						range[1] -> antenna 0, chirp 0, range index 1
- *						range[num_samples_per_chirp / 2] -> antenna 0, chirp 1, range index 0
+ *						range[range_fft_len] -> antenna 0, chirp 1, range index 0
  *
  * @param [out] doppler	Array containing the doppler FFT for the given bin
  * 						The array must be allocated by the caller function
@@ -34,18 +65,190 @@
  * @param [in] win	Window to be applied to the signal before computing FFT
  * @param [in] bin_index	Index of the bin for which the doppler FFT has to be computed [0] to [(num_samples_per_chirp / 2) - 1]
  * @param [in] antenna_index	Index of the antenna for which the doppler FFT has to be computed
- * @param [in] num_chirps_per_frame	Number of chirps per frame
  * @param [in] range_fft_len	Length of the computed range FFT (per chirp - might vary depending on zero padding)
  *
  * @retval 0 On success
  */
-int32_t doppler_fft_bin_do(cfloat32_t* range,
+int32_t doppler_fft_bin_do(const doppler_fft_ctx_t* ctx,
+		cfloat32_t* range,
 		cfloat32_t* doppler,
 		bool mean_removal,
 		const float32_t* win,
 		uint16_t bin_index,
 		uint16_t antenna_index,
-		uint16_t num_chirps_per_frame,
 		uint16_t range_fft_len);
 
+/**
+ * @brief Compute a single value (velocity_index) of the Doppler FFT of one bin (Goertzel algorithm)
+ *
+ * Same value as doppler_fft_bin_do(...)[velocity_index], for about 2 * num_chirps_per_frame operations.
+ *
+ * @param [in] ctx		Doppler FFT context (see doppler_fft_ctx_init)
+ * @param [in] range_bin	Range value of the bin for each chirp (see range_fft_bin_do), size is num_chirps_per_frame
+ * @param [out] cell	Doppler value
+ * @param [in] mean_removal	Perform mean removal or not before computing the Doppler value
+ * @param [in] win	Window to be applied to the signal before computing the Doppler value (or NULL)
+ * @param [in] velocity_index	Index of the Doppler bin, [0] to [num_chirps_per_frame - 1]
+ *
+ * @retval 0 On success
+ */
+int32_t doppler_fft_cell_do(const doppler_fft_ctx_t* ctx,
+		const cfloat32_t* range_bin,
+		cfloat32_t* cell,
+		bool mean_removal,
+		const float32_t* win,
+		uint16_t velocity_index);
+
+/**
+ * @brief Compute the range-Doppler map of the antennas of the mask (Doppler FFT of every bin of the range cube)
+ *
+ * Same processing as doppler_fft_bin_do for each bin, but done in one pass: the gather, the mean removal and the
+ * window are merged, and the FFT is computed in place inside of map.
+ *
+ * @param [in] ctx		Doppler FFT context (see doppler_fft_ctx_init)
+ *
+ * @param [in] range	Array containing the range FFT (see doppler_fft_bin_do)
+ *
+ * @param [out] map		Range-Doppler map, bin major:
+ * 						map[(antenna_index * range_fft_len + bin_index) * num_chirps_per_frame + velocity_index]
+ * 						Size of this buffer is (index of the last antenna of the mask + 1) * range_fft_len * num_chirps_per_frame * sizeof(cfloat32_t)
+ * 						With RANGE_FFT_LAYOUT_BIN_MAJOR, map can be range itself (computed in place, the range values of the antennas of the mask are then lost)
+ *
+ * @param [in] mean_removal	Perform mean removal or not before computing FFT
+ * @param [in] win	Window to be applied to the signal before computing FFT (or NULL)
+ * @param [in] antenna_count	Number of antennas contained in range
+ * @param [in] antenna_mask		Mask used to specify which antenna should be computed
+ * @param [in] range_fft_len	Length of the computed range FFT (per chirp - might vary depending on zero padding)
+ * @param [in] bin_enabled	Bins to compute (size is range_fft_len, see doppler_fft_energy), the values of the other bins are set to 0. NULL -> all the bins
+ *
+ * @retval 0 On success
+ */
+int32_t doppler_fft_map_do(const doppler_fft_ctx_t* ctx,
+		cfloat32_t* range,
+		cfloat32_t* map,
+		bool mean_removal,
+		const float32_t* win,
+		uint8_t antenna_count,
+		uint8_t antenna_mask,
+		uint16_t range_fft_len,
+		const bool* bin_enabled);
+
+/**
+ * @brief Slow-time energy of each bin of one antenna: sum over the chirps of |range value - mean|^2
+ *
+ * Cheap pre-screen of the Doppler FFT: with a window w, each Doppler value of the bin satisfies
+ * |doppler|^2 <= sum(w^2) * energy (Cauchy-Schwarz), so a bin with a small energy cannot contain a peak.
+ *
+ * @param [in] ctx		Doppler FFT context (see doppler_fft_ctx_init)
+ * @param [in] range	Array containing the range FFT (see doppler_fft_bin_do)
+ * @param [out] energy	Energy of each bin, size is range_fft_len
+ * @param [in] mean_removal	Remove the mean before computing the energy (same as the Doppler FFT)
+ * @param [in] antenna_index	Index of the antenna
+ * @param [in] range_fft_len	Length of the computed range FFT (per chirp - might vary depending on zero padding)
+ *
+ * @retval 0 On success
+ */
+int32_t doppler_fft_energy(const doppler_fft_ctx_t* ctx,
+		const cfloat32_t* range,
+		float32_t* energy,
+		bool mean_removal,
+		uint16_t antenna_index,
+		uint16_t range_fft_len);
+
+/**
+ * @brief Fixed point version of doppler_fft_energy (Q15 range FFT, see range_fft_q15_do), energy in the scale of the float version
+ */
+int32_t doppler_fft_energy_q15(const doppler_fft_ctx_t* ctx,
+		const q15_t* range,
+		const int8_t* range_exponent,
+		float32_t* energy,
+		bool mean_removal,
+		uint16_t antenna_index,
+		uint16_t range_fft_len);
+
+/**
+ * @brief Search the value with the biggest magnitude of a range-Doppler map (or of any complex buffer)
+ *
+ * Works on the magnitude squared (no square root per value), block by block with arm_cmplx_mag_squared_f32 and arm_max_f32.
+ * As a scalar search, the first maximum is returned.
+ *
+ * @param [in] map		Complex values
+ * @param [in] len		Number of complex values contained in map
+ * @param [in] work		Work buffer. Size of this buffer should be block_len floats
+ * @param [in] block_len	Number of values processed per block
+ * @param [out] index	Index of the peak inside of map (0 if all the values are 0)
+ * @param [out] magnitude_squared	Magnitude squared of the peak
+ *
+ * @retval 0 On success
+ */
+int32_t doppler_fft_peak_search(const cfloat32_t* map,
+		uint32_t len,
+		float32_t* work,
+		uint32_t block_len,
+		uint32_t* index,
+		float32_t* magnitude_squared);
+
+/**
+ * @brief Convert a window into the Q31 table used by doppler_fft_bin_q31_do
+ *
+ * @param [out] win_table	Generated table. Size of this buffer should be num_chirps_per_frame
+ * @param [in] win	Window
+ * @param [in] num_chirps_per_frame	Number of chirps per frame
+ */
+void doppler_fft_window_q31_init(q31_t* win_table, const float32_t* win, uint16_t num_chirps_per_frame);
+
+/**
+ * @brief Fixed point version of doppler_fft_bin_do: Doppler FFT computed in Q31 with block floating point scaling
+ *
+ * The Q15 chirps (see range_fft_q15_do) are aligned on the biggest exponent of the antenna,
+ * normalized to use the full Q31 range, then transformed.
+ * The result is converted back to float (same scale as doppler_fft_bin_do).
+ *
+ * @param [in] range	Q15 range FFT (see range_fft_q15_do)
+ * @param [in] range_exponent	Block exponent of each chirp (see range_fft_q15_do)
+ * @param [out] doppler	Array containing the doppler FFT for the given bin. Size of this buffer is num_chirps_per_frame * sizeof(cfloat32_t)
+ * @param [in] work		Work buffer. Size of this buffer should be 2 * num_chirps_per_frame q31_t
+ * @param [in] win		Window table generated by doppler_fft_window_q31_init (or NULL)
+ *
+ * Other parameters: see doppler_fft_bin_do
+ *
+ * @retval 0 On success
+ */
+int32_t doppler_fft_bin_q31_do(const doppler_fft_ctx_t* ctx,
+		const q15_t* range,
+		const int8_t* range_exponent,
+		cfloat32_t* doppler,
+		q31_t* work,
+		bool mean_removal,
+		const q31_t* win,
+		uint16_t bin_index,
+		uint16_t antenna_index,
+		uint16_t range_fft_len);
+
+/**
+ * @brief Fixed point version of doppler_fft_map_do (each bin computed as in doppler_fft_bin_q31_do, the map is in float)
+ *
+ * @param [in] range	Q15 range FFT (see range_fft_q15_do)
+ * @param [in] range_exponent	Block exponent of each chirp (see range_fft_q15_do)
+ * @param [out] map		Range-Doppler map, same layout as doppler_fft_map_do (cannot be computed in place)
+ * @param [in] bin_enabled	Bins to compute (see doppler_fft_map_do)
+ * @param [in] work		Work buffer. Size of this buffer should be 2 * num_chirps_per_frame q31_t
+ * @param [in] win		Window table generated by doppler_fft_window_q31_init (or NULL)
+ *
+ * Other parameters: see doppler_fft_map_do
+ *
+ * @retval 0 On success
+ */
+int32_t doppler_fft_map_q31_do(const doppler_fft_ctx_t* ctx,
+		const q15_t* range,
+		const int8_t* range_exponent,
+		cfloat32_t* map,
+		q31_t* work,
+		bool mean_removal,
+		const q31_t* win,
+		uint8_t antenna_count,
+		uint8_t antenna_mask,
+		uint16_t range_fft_len,
+		const bool* bin_enabled);
+
 #endif /* PRESENCE_DETECTION_DOPPLER_FFT_H_ */
@@ -0,0 +1,95 @@
+/*
+ * frame_pool.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ * Rutronik Elektronische Bauelemente GmbH Disclaimer: The evaluation board
+ * including the software is for testing purposes only and,
+ * because it has limited functions and limited resilience, is not suitable
+ * for permanent use under real conditions. If the evaluation board is
+ * nevertheless used under real conditions, this is done at one’s responsibility;
+ * any liability of Rutronik is insofar excluded
+ */
+
+#include "frame_pool.h"
+
+#include <string.h>
+
+int32_t frame_pool_init(frame_pool_t* pool, uint16_t* memory, uint16_t chirps_per_frame, uint16_t chirp_len)
+{
+	if ((pool == NULL) || (memory == NULL)) return -1;
+	if ((chirps_per_frame == 0) || (chirp_len == 0)) return -2;
+
+	memset(pool, 0, sizeof(frame_pool_t));
+	pool->memory = memory;
+	pool->chirps_per_frame = chirps_per_frame;
+	pool->chirp_len = chirp_len;
+
+	return 0;
+}
+
+uint16_t* frame_pool_producer_block(frame_pool_t* pool)
+{
+	if (pool->position == 0)
+	{
+		// New frame: all the frames still owned by the consumer -> drop it
+		pool->dropping = ((pool->write - pool->read) >= FRAME_POOL_SIZE);
+	}
+
+	if (pool->dropping) return NULL;
+
+	const uint32_t slot = pool->write % FRAME_POOL_SIZE;
+	return &pool->memory[(slot * pool->chirps_per_frame + pool->position) * pool->chirp_len];
+}
+
+void frame_pool_producer_commit(frame_pool_t* pool, uint16_t chirp_count)
+{
+	pool->position += chirp_count;
+	if (pool->position > pool->chirps_per_frame) pool->position = pool->chirps_per_frame;
+
+	if (!pool->dropping)
+	{
+		// Published after the samples are written: the consumer can read the chirps [0, filled[
+		pool->filled[pool->write % FRAME_POOL_SIZE] = pool->position;
+	}
+
+	if (pool->position == pool->chirps_per_frame)
+	{
+		pool->position = 0;
+
+		if (pool->dropping)
+		{
+			pool->overruns++;
+		}
+		else
+		{
+			pool->write++;
+		}
+	}
+}
+
+uint16_t* frame_pool_consumer_peek(frame_pool_t* pool, uint16_t* chirps_available)
+{
+	const uint32_t slot = pool->read % FRAME_POOL_SIZE;
+	const uint16_t filled = pool->filled[slot];
+
+	if (filled == 0) return NULL;
+
+	if (chirps_available != NULL) *chirps_available = filled;
+
+	return &pool->memory[slot * pool->chirps_per_frame * pool->chirp_len];
+}
+
+void frame_pool_consumer_release(frame_pool_t* pool)
+{
+	const uint32_t slot = pool->read % FRAME_POOL_SIZE;
+
+	// The producer only fills this frame again after read is incremented
+	pool->filled[slot] = 0;
+	pool->read++;
+}
+
+uint32_t frame_pool_overruns(const frame_pool_t* pool)
+{
+	return pool->overruns;
+}
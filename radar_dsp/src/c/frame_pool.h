@@ -0,0 +1,98 @@
+/*
+ * frame_pool.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ * Pool of frame buffers handed over between the acquisition (producer, e.g. FIFO interrupt) and the processing (consumer)
+ *
+ * Rutronik Elektronische Bauelemente GmbH Disclaimer: The evaluation board
+ * including the software is for testing purposes only and,
+ * because it has limited functions and limited resilience, is not suitable
+ * for permanent use under real conditions. If the evaluation board is
+ * nevertheless used under real conditions, this is done at one’s responsibility;
+ * any liability of Rutronik is insofar excluded
+ */
+
+#ifndef FRAME_POOL_H_
+#define FRAME_POOL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Number of frames of the pool: one filled by the producer while the consumer processes the other
+ */
+#define FRAME_POOL_SIZE 2U
+
+/**
+ * Single producer / single consumer pool, no lock: each field is written by one side only.
+ *
+ * Frames are filled chunk by chunk (e.g. a few chirps per FIFO interrupt) directly inside of the pool (no copy).
+ * The consumer can read the chirps of a frame already written while the following ones are acquired.
+ * When the consumer still owns all the frames at the beginning of a new frame, the new frame is dropped and counted.
+ */
+typedef struct
+{
+	uint16_t* memory;				/**< FRAME_POOL_SIZE frames of chirps_per_frame * chirp_len samples */
+	uint16_t chirps_per_frame;
+	uint16_t chirp_len;				/**< Samples per chirp (all antennas) */
+
+	volatile uint16_t filled[FRAME_POOL_SIZE];	/**< Chirps written in each frame (producer) */
+	volatile uint32_t write;		/**< Frames completed by the producer */
+	volatile uint32_t read;			/**< Frames released by the consumer */
+	volatile uint32_t overruns;		/**< Frames dropped by the producer (no free frame) */
+
+	uint16_t position;				/**< Producer: chirps of the current frame already acquired */
+	bool dropping;					/**< Producer: current frame dropped */
+} frame_pool_t;
+
+/**
+ * @brief Initialize a pool
+ *
+ * @param [out] pool	Pool to initialize
+ * @param [in] memory	Frames. Size of this buffer should be FRAME_POOL_SIZE * chirps_per_frame * chirp_len samples
+ * @param [in] chirps_per_frame	Number of chirps per frame
+ * @param [in] chirp_len	Number of samples per chirp (all antennas)
+ *
+ * @retval 0 	Success
+ * @retval != 0	Error occurred
+ */
+int32_t frame_pool_init(frame_pool_t* pool, uint16_t* memory, uint16_t chirps_per_frame, uint16_t chirp_len);
+
+/**
+ * @brief Producer: where to write the next chirps of the current frame
+ *
+ * @retval Position of the next chirp inside of the current frame
+ * @retval NULL	No free frame, the current frame is dropped (the chirps still have to be read, e.g. to empty the FIFO)
+ */
+uint16_t* frame_pool_producer_block(frame_pool_t* pool);
+
+/**
+ * @brief Producer: chirp_count chirps were written at the position given by frame_pool_producer_block
+ *
+ * Once the last chirp of the frame is written, the frame is completed and the next call of
+ * frame_pool_producer_block starts a new frame.
+ */
+void frame_pool_producer_commit(frame_pool_t* pool, uint16_t chirp_count);
+
+/**
+ * @brief Consumer: oldest frame not released yet (complete or being acquired)
+ *
+ * @param [out] chirps_available	Number of chirps of the frame already written (chirps_per_frame -> complete)
+ *
+ * @retval Frame
+ * @retval NULL	No chirp of a new frame written yet
+ */
+uint16_t* frame_pool_consumer_peek(frame_pool_t* pool, uint16_t* chirps_available);
+
+/**
+ * @brief Consumer: give the complete frame returned by frame_pool_consumer_peek back to the producer
+ */
+void frame_pool_consumer_release(frame_pool_t* pool);
+
+/**
+ * @brief Number of frames dropped since frame_pool_init because the consumer was too slow
+ */
+uint32_t frame_pool_overruns(const frame_pool_t* pool);
+
+#endif /* FRAME_POOL_H_ */
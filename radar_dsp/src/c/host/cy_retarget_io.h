@@ -0,0 +1,21 @@
+/*
+ * cy_retarget_io.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ * Host (x86 / Linux) replacement of the retarget-io library: printf goes to the standard output
+ *
+ * Rutronik Elektronische Bauelemente GmbH Disclaimer: The evaluation board
+ * including the software is for testing purposes only and,
+ * because it has limited functions and limited resilience, is not suitable
+ * for permanent use under real conditions. If the evaluation board is
+ * nevertheless used under real conditions, this is done at one’s responsibility;
+ * any liability of Rutronik is insofar excluded
+ */
+
+#ifndef HOST_CY_RETARGET_IO_H_
+#define HOST_CY_RETARGET_IO_H_
+
+#include <stdio.h>
+
+#endif /* HOST_CY_RETARGET_IO_H_ */
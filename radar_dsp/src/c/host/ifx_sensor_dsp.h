@@ -0,0 +1,199 @@
+/*
+ * ifx_sensor_dsp.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ * Host (x86 / Linux) replacement of the ifx_sensor_dsp + CMSIS-DSP subset used by the radar chain.
+ * Same names and signatures as the target libraries, so range_fft.c, doppler_fft.c and radar_processing.c
+ * compile unchanged. Put this directory in front of the include path and link ifx_sensor_dsp_host.c, e.g.:
+ *
+ *   gcc -O3 -march=native -Ihost host/ifx_sensor_dsp_host.c range_fft.c doppler_fft.c radar_processing.c ... -lm -lpthread
+ *
+ * The Makefile of this directory builds the chain with radar_replay.c (replay of a recording, results and time per frame).
+ *
+ * Element wise operations and the FFT butterflies are vectorized with AVX (if __AVX__) or SSE3 (if __SSE3__),
+ * a plain C path is used otherwise. Results match the target within float rounding tolerance.
+ *
+ * Rutronik Elektronische Bauelemente GmbH Disclaimer: The evaluation board
+ * including the software is for testing purposes only and,
+ * because it has limited functions and limited resilience, is not suitable
+ * for permanent use under real conditions. If the evaluation board is
+ * nevertheless used under real conditions, this is done at one’s responsibility;
+ * any liability of Rutronik is insofar excluded
+ */
+
+#ifndef HOST_IFX_SENSOR_DSP_H_
+#define HOST_IFX_SENSOR_DSP_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+typedef float float32_t;
+typedef double float64_t;
+typedef int8_t q7_t;
+typedef int16_t q15_t;
+typedef int32_t q31_t;
+typedef int64_t q63_t;
+
+/**
+ * Complex float, stored as [real, imag] (same memory layout as the target cfloat32_t)
+ */
+typedef float _Complex cfloat32_t;
+
+#define CREAL_F32(x) (((float32_t*)&(x))[0])
+#define CIMAG_F32(x) (((float32_t*)&(x))[1])
+
+typedef enum
+{
+	ARM_MATH_SUCCESS = 0,
+	ARM_MATH_ARGUMENT_ERROR = -1,
+	ARM_MATH_LENGTH_ERROR = -2,
+	ARM_MATH_SIZE_MISMATCH = -3,
+	ARM_MATH_NANINF = -4,
+	ARM_MATH_SINGULAR = -5,
+	ARM_MATH_TEST_FAILURE = -6
+} arm_status;
+
+#define IFX_SENSOR_DSP_STATUS_OK		(0)
+#define IFX_SENSOR_DSP_ARGUMENT_ERROR	(-100)
+
+/**
+ * @brief Complex FFT instance
+ *
+ * pTwiddle points to the first stage of the shared (read only) twiddle table,
+ * the instance itself does not own memory and can be copied freely.
+ */
+typedef struct
+{
+	uint16_t fftLen;
+	const float32_t* pTwiddle;
+	const uint16_t* pBitRevTable;
+	uint16_t bitRevLength;
+} arm_cfft_instance_f32;
+
+/**
+ * @brief Real FFT instance (fftLenRFFT real samples -> fftLenRFFT / 2 complex values)
+ */
+typedef struct
+{
+	arm_cfft_instance_f32 Sint;
+	uint16_t fftLenRFFT;
+	const float32_t* pTwiddleRFFT;
+} arm_rfft_fast_instance_f32;
+
+/**
+ * @brief Fixed point complex FFT instances
+ */
+typedef struct
+{
+	uint16_t fftLen;
+	const q15_t* pTwiddle;
+	const uint16_t* pBitRevTable;
+	uint16_t bitRevLength;
+} arm_cfft_instance_q15;
+
+typedef struct
+{
+	uint16_t fftLen;
+	const q31_t* pTwiddle;
+	const uint16_t* pBitRevTable;
+	uint16_t bitRevLength;
+} arm_cfft_instance_q31;
+
+/**
+ * @brief Fixed point real FFT instance
+ */
+typedef struct
+{
+	uint32_t fftLenReal;
+	uint8_t ifftFlagR;
+	uint8_t bitReverseFlagR;
+	uint32_t twidCoefRModifier;
+	const q15_t* pTwiddleAReal;
+	const q15_t* pTwiddleBReal;
+	const arm_cfft_instance_q15* pCfft;
+} arm_rfft_instance_q15;
+
+arm_status arm_cfft_init_f32(arm_cfft_instance_f32* S, uint16_t fftLen);
+
+/**
+ * @brief In place complex FFT (no scaling for the forward direction, 1/N for the inverse)
+ */
+void arm_cfft_f32(const arm_cfft_instance_f32* S, float32_t* p1, uint8_t ifftFlag, uint8_t bitReverseFlag);
+
+arm_status arm_rfft_fast_init_f32(arm_rfft_fast_instance_f32* S, uint16_t fftLen);
+
+/**
+ * @brief Real FFT, CMSIS packed output format
+ *
+ * p[0] -> real part of bin 0, p[1] -> real part of bin fftLen / 2, then [real, imag] of bins 1 to (fftLen / 2) - 1
+ * As on target, the input buffer is used as scratch memory and is modified.
+ */
+void arm_rfft_fast_f32(const arm_rfft_fast_instance_f32* S, float32_t* p, float32_t* pOut, uint8_t ifftFlag);
+
+arm_status arm_cfft_init_q15(arm_cfft_instance_q15* S, uint16_t fftLen);
+
+/**
+ * @brief In place complex FFT in Q15. As on target, the output is downscaled by fftLen (one bit per stage)
+ */
+void arm_cfft_q15(const arm_cfft_instance_q15* S, q15_t* p1, uint8_t ifftFlag, uint8_t bitReverseFlag);
+
+arm_status arm_cfft_init_q31(arm_cfft_instance_q31* S, uint16_t fftLen);
+
+/**
+ * @brief In place complex FFT in Q31. As on target, the output is downscaled by fftLen (one bit per stage)
+ */
+void arm_cfft_q31(const arm_cfft_instance_q31* S, q31_t* p1, uint8_t ifftFlag, uint8_t bitReverseFlag);
+
+/**
+ * @brief Init the Q15 real FFT (only the forward transform, ifftFlagR = 0, is available on host)
+ */
+arm_status arm_rfft_init_q15(arm_rfft_instance_q15* S, uint32_t fftLenReal, uint32_t ifftFlagR, uint32_t bitReverseFlag);
+
+/**
+ * @brief Real FFT in Q15
+ *
+ * pDst receives the complete (conjugate symmetric) spectrum: fftLenReal complex values [real, imag], so 2 * fftLenReal q15_t
+ * As on target, the output is downscaled by fftLenReal / 2 and the input buffer is modified.
+ */
+void arm_rfft_q15(const arm_rfft_instance_q15* S, q15_t* pSrc, q15_t* pDst);
+
+void arm_mult_f32(const float32_t* pSrcA, const float32_t* pSrcB, float32_t* pDst, uint32_t blockSize);
+
+void arm_cmplx_mult_real_f32(const float32_t* pSrcCmplx, const float32_t* pSrcReal, float32_t* pCmplxDst, uint32_t numSamples);
+
+/**
+ * @brief Magnitude squared of numSamples complex values: pDst[i] = real^2 + imag^2
+ */
+void arm_cmplx_mag_squared_f32(const float32_t* pSrc, float32_t* pDst, uint32_t numSamples);
+
+/**
+ * @brief Maximum value of the buffer and index of its first occurrence
+ */
+void arm_max_f32(const float32_t* pSrc, uint32_t blockSize, float32_t* pResult, uint32_t* pIndex);
+
+arm_status arm_sqrt_f32(float32_t in, float32_t* pOut);
+
+/**
+ * @brief Subtract the mean value from the buffer (in place)
+ */
+void ifx_mean_removal_f32(float32_t* buffer, uint32_t len);
+
+/**
+ * @brief Subtract the complex mean value from the buffer (in place)
+ */
+void ifx_cmplx_mean_removal_f32(cfloat32_t* buffer, uint32_t len);
+
+/**
+ * @brief Generate a (symmetric) 4 terms Blackman-Harris window
+ */
+void ifx_window_blackmanharris_f32(float32_t* win, uint32_t len);
+
+#endif /* HOST_IFX_SENSOR_DSP_H_ */
@@ -0,0 +1,805 @@
+/*
+ * ifx_sensor_dsp_host.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ * Host implementation of the ifx_sensor_dsp + CMSIS-DSP subset (see ifx_sensor_dsp.h)
+ *
+ * Rutronik Elektronische Bauelemente GmbH Disclaimer: The evaluation board
+ * including the software is for testing purposes only and,
+ * because it has limited functions and limited resilience, is not suitable
+ * for permanent use under real conditions. If the evaluation board is
+ * nevertheless used under real conditions, this is done at one’s responsibility;
+ * any liability of Rutronik is insofar excluded
+ */
+
+#include "ifx_sensor_dsp.h"
+
+#include <pthread.h>
+
+#if defined(__AVX__) || defined(__SSE3__)
+#include <immintrin.h>
+#endif
+
+/**
+ * Biggest supported FFT length (same limit as CMSIS-DSP)
+ */
+#define HOST_FFT_MAX_LEN 4096U
+
+/**
+ * @var twiddle
+ * Shared twiddle table, stored stage by stage: the stage of span m (m = 4096, 2048, ..., 2)
+ * starts at complex index (HOST_FFT_MAX_LEN - m) and contains exp(-2*pi*i*j/m) for j = 0 to (m/2) - 1
+ * Since the stage of span m only depends on m, an FFT of length N just starts at stage N.
+ * The first stage of length N is also the twiddle table needed by the real FFT split.
+ */
+static float32_t twiddle[2 * (HOST_FFT_MAX_LEN - 1)];
+static pthread_once_t twiddle_once = PTHREAD_ONCE_INIT;
+
+/**
+ * @var twiddle_q15
+ * @var twiddle_q31
+ * Same tables (same layout) in fixed point
+ */
+static q15_t twiddle_q15[2 * (HOST_FFT_MAX_LEN - 1)];
+static q31_t twiddle_q31[2 * (HOST_FFT_MAX_LEN - 1)];
+
+/**
+ * @var cfft_q15_instances
+ * Complex FFT used by the Q15 real FFT, index is log2(fftLen)
+ */
+static arm_cfft_instance_q15 cfft_q15_instances[13];
+
+static void twiddle_generate(void)
+{
+	for (uint32_t m = HOST_FFT_MAX_LEN; m >= 2; m >>= 1)
+	{
+		float32_t* stage = &twiddle[2 * (HOST_FFT_MAX_LEN - m)];
+		for (uint32_t j = 0; j < m / 2; ++j)
+		{
+			const double angle = -2.0 * M_PI * (double)j / (double)m;
+			stage[2 * j] = (float32_t)cos(angle);
+			stage[2 * j + 1] = (float32_t)sin(angle);
+		}
+	}
+
+	for (uint32_t i = 0; i < 2 * (HOST_FFT_MAX_LEN - 1); ++i)
+	{
+		const double value = (double)twiddle[i];
+		twiddle_q15[i] = (q15_t)fmax(-32768.0, fmin(32767.0, round(value * 32768.0)));
+		twiddle_q31[i] = (q31_t)fmax(-2147483648.0, fmin(2147483647.0, round(value * 2147483648.0)));
+	}
+}
+
+static const float32_t* twiddle_stage(uint32_t span)
+{
+	pthread_once(&twiddle_once, twiddle_generate);
+	return &twiddle[2 * (HOST_FFT_MAX_LEN - span)];
+}
+
+static const q15_t* twiddle_stage_q15(uint32_t span)
+{
+	pthread_once(&twiddle_once, twiddle_generate);
+	return &twiddle_q15[2 * (HOST_FFT_MAX_LEN - span)];
+}
+
+static const q31_t* twiddle_stage_q31(uint32_t span)
+{
+	pthread_once(&twiddle_once, twiddle_generate);
+	return &twiddle_q31[2 * (HOST_FFT_MAX_LEN - span)];
+}
+
+static bool is_power_of_two(uint32_t value)
+{
+	return (value != 0) && ((value & (value - 1)) == 0);
+}
+
+arm_status arm_cfft_init_f32(arm_cfft_instance_f32* S, uint16_t fftLen)
+{
+	if (S == NULL) return ARM_MATH_ARGUMENT_ERROR;
+	if ((fftLen < 16) || (fftLen > HOST_FFT_MAX_LEN) || !is_power_of_two(fftLen)) return ARM_MATH_ARGUMENT_ERROR;
+
+	S->fftLen = fftLen;
+	S->pTwiddle = twiddle_stage(fftLen);
+	S->pBitRevTable = NULL;
+	S->bitRevLength = 0;
+
+	return ARM_MATH_SUCCESS;
+}
+
+arm_status arm_rfft_fast_init_f32(arm_rfft_fast_instance_f32* S, uint16_t fftLen)
+{
+	if (S == NULL) return ARM_MATH_ARGUMENT_ERROR;
+	if ((fftLen < 32) || (fftLen > HOST_FFT_MAX_LEN) || !is_power_of_two(fftLen)) return ARM_MATH_ARGUMENT_ERROR;
+
+	arm_status status = arm_cfft_init_f32(&S->Sint, fftLen / 2);
+	if (status != ARM_MATH_SUCCESS) return status;
+
+	S->fftLenRFFT = fftLen;
+	S->pTwiddleRFFT = twiddle_stage(fftLen);
+
+	return ARM_MATH_SUCCESS;
+}
+
+/**
+ * One radix-2 decimation in frequency butterfly group:
+ * a[j] = a[j] + b[j] and b[j] = (a[j] - b[j]) * w[j] for j = 0 to count - 1 (complex values)
+ */
+static void butterfly_dif(float32_t* a, float32_t* b, const float32_t* w, uint32_t count)
+{
+	uint32_t j = 0;
+
+#if defined(__AVX__)
+	for (; j + 4 <= count; j += 4)
+	{
+		__m256 va = _mm256_loadu_ps(&a[2 * j]);
+		__m256 vb = _mm256_loadu_ps(&b[2 * j]);
+		__m256 vw = _mm256_loadu_ps(&w[2 * j]);
+
+		__m256 sum = _mm256_add_ps(va, vb);
+		__m256 diff = _mm256_sub_ps(va, vb);
+
+		// (dr + i.di) * (wr + i.wi)
+		__m256 wr = _mm256_moveldup_ps(vw);
+		__m256 wi = _mm256_movehdup_ps(vw);
+		__m256 swapped = _mm256_permute_ps(diff, 0xB1);
+		__m256 product = _mm256_addsub_ps(_mm256_mul_ps(diff, wr), _mm256_mul_ps(swapped, wi));
+
+		_mm256_storeu_ps(&a[2 * j], sum);
+		_mm256_storeu_ps(&b[2 * j], product);
+	}
+#endif
+
+#if defined(__SSE3__)
+	for (; j + 2 <= count; j += 2)
+	{
+		__m128 va = _mm_loadu_ps(&a[2 * j]);
+		__m128 vb = _mm_loadu_ps(&b[2 * j]);
+		__m128 vw = _mm_loadu_ps(&w[2 * j]);
+
+		__m128 sum = _mm_add_ps(va, vb);
+		__m128 diff = _mm_sub_ps(va, vb);
+
+		__m128 wr = _mm_moveldup_ps(vw);
+		__m128 wi = _mm_movehdup_ps(vw);
+		__m128 swapped = _mm_shuffle_ps(diff, diff, 0xB1);
+		__m128 product = _mm_addsub_ps(_mm_mul_ps(diff, wr), _mm_mul_ps(swapped, wi));
+
+		_mm_storeu_ps(&a[2 * j], sum);
+		_mm_storeu_ps(&b[2 * j], product);
+	}
+#endif
+
+	for (; j < count; ++j)
+	{
+		const float32_t ar = a[2 * j];
+		const float32_t ai = a[2 * j + 1];
+		const float32_t br = b[2 * j];
+		const float32_t bi = b[2 * j + 1];
+		const float32_t dr = ar - br;
+		const float32_t di = ai - bi;
+
+		a[2 * j] = ar + br;
+		a[2 * j + 1] = ai + bi;
+		b[2 * j] = dr * w[2 * j] - di * w[2 * j + 1];
+		b[2 * j + 1] = dr * w[2 * j + 1] + di * w[2 * j];
+	}
+}
+
+static void bit_reverse(float32_t* p, uint32_t len)
+{
+	uint32_t j = 0;
+	for (uint32_t i = 0; i < len - 1; ++i)
+	{
+		if (i < j)
+		{
+			float32_t tmp_r = p[2 * i];
+			float32_t tmp_i = p[2 * i + 1];
+			p[2 * i] = p[2 * j];
+			p[2 * i + 1] = p[2 * j + 1];
+			p[2 * j] = tmp_r;
+			p[2 * j + 1] = tmp_i;
+		}
+
+		uint32_t bit = len >> 1;
+		while (j & bit)
+		{
+			j ^= bit;
+			bit >>= 1;
+		}
+		j |= bit;
+	}
+}
+
+static void conjugate(float32_t* p, uint32_t len)
+{
+	for (uint32_t i = 0; i < len; ++i)
+	{
+		p[2 * i + 1] = -p[2 * i + 1];
+	}
+}
+
+void arm_cfft_f32(const arm_cfft_instance_f32* S, float32_t* p1, uint8_t ifftFlag, uint8_t bitReverseFlag)
+{
+	const uint32_t len = S->fftLen;
+
+	// Inverse computed as conj(FFT(conj(x))) / N
+	if (ifftFlag) conjugate(p1, len);
+
+	for (uint32_t span = len; span >= 2; span >>= 1)
+	{
+		const uint32_t half = span / 2;
+		const float32_t* w = S->pTwiddle + 2 * (len - span);
+
+		for (uint32_t group = 0; group < len; group += span)
+		{
+			float32_t* a = &p1[2 * group];
+			butterfly_dif(a, a + 2 * half, w, half);
+		}
+	}
+
+	if (bitReverseFlag) bit_reverse(p1, len);
+
+	if (ifftFlag)
+	{
+		const float32_t scale = 1.0f / (float32_t)len;
+		for (uint32_t i = 0; i < len; ++i)
+		{
+			p1[2 * i] = p1[2 * i] * scale;
+			p1[2 * i + 1] = -p1[2 * i + 1] * scale;
+		}
+	}
+}
+
+void arm_rfft_fast_f32(const arm_rfft_fast_instance_f32* S, float32_t* p, float32_t* pOut, uint8_t ifftFlag)
+{
+	const uint32_t half = S->fftLenRFFT / 2;
+	const float32_t* w = S->pTwiddleRFFT;
+
+	if (ifftFlag == 0)
+	{
+		// Real signal of length N seen as complex signal z[n] = x[2n] + i.x[2n+1] of length N/2
+		arm_cfft_f32(&S->Sint, p, 0, 1);
+
+		// Split: X[k] = E[k] + W^k.O[k]
+		// with E[k] = (Z[k] + conj(Z[N/2-k])) / 2 and O[k] = -i.(Z[k] - conj(Z[N/2-k])) / 2
+		pOut[0] = p[0] + p[1];
+		pOut[1] = p[0] - p[1];
+
+		for (uint32_t k = 1; k < half; ++k)
+		{
+			const float32_t zr = p[2 * k];
+			const float32_t zi = p[2 * k + 1];
+			const float32_t cr = p[2 * (half - k)];
+			const float32_t ci = -p[2 * (half - k) + 1];
+
+			const float32_t er = 0.5f * (zr + cr);
+			const float32_t ei = 0.5f * (zi + ci);
+			const float32_t odd_r = 0.5f * (zi - ci);
+			const float32_t odd_i = -0.5f * (zr - cr);
+
+			const float32_t wr = w[2 * k];
+			const float32_t wi = w[2 * k + 1];
+
+			pOut[2 * k] = er + (odd_r * wr - odd_i * wi);
+			pOut[2 * k + 1] = ei + (odd_r * wi + odd_i * wr);
+		}
+	}
+	else
+	{
+		// Merge: Z[k] = E[k] + i.O[k]
+		// with E[k] = (X[k] + conj(X[N/2-k])) / 2 and O[k] = conj(W^k).(X[k] - conj(X[N/2-k])) / 2
+		const float32_t x0 = p[0];
+		const float32_t xn = p[1];
+		pOut[0] = 0.5f * (x0 + xn);
+		pOut[1] = 0.5f * (x0 - xn);
+
+		for (uint32_t k = 1; k < half; ++k)
+		{
+			const float32_t xr = p[2 * k];
+			const float32_t xi = p[2 * k + 1];
+			const float32_t cr = p[2 * (half - k)];
+			const float32_t ci = -p[2 * (half - k) + 1];
+
+			const float32_t er = 0.5f * (xr + cr);
+			const float32_t ei = 0.5f * (xi + ci);
+			const float32_t dr = 0.5f * (xr - cr);
+			const float32_t di = 0.5f * (xi - ci);
+
+			const float32_t wr = w[2 * k];
+			const float32_t wi = -w[2 * k + 1];
+
+			const float32_t odd_r = dr * wr - di * wi;
+			const float32_t odd_i = dr * wi + di * wr;
+
+			pOut[2 * k] = er - odd_i;
+			pOut[2 * k + 1] = ei + odd_r;
+		}
+
+		arm_cfft_f32(&S->Sint, pOut, 1, 1);
+	}
+}
+
+static q15_t saturate_q15(int32_t value)
+{
+	if (value > INT16_MAX) return INT16_MAX;
+	if (value < INT16_MIN) return INT16_MIN;
+	return (q15_t)value;
+}
+
+static q31_t saturate_q31(int64_t value)
+{
+	if (value > INT32_MAX) return INT32_MAX;
+	if (value < INT32_MIN) return INT32_MIN;
+	return (q31_t)value;
+}
+
+/**
+ * Generic bit reversal for fixed point complex buffers
+ */
+#define HOST_BIT_REVERSE(type, p, len) \
+	do { \
+		uint32_t j = 0; \
+		for (uint32_t i = 0; i < (len) - 1; ++i) \
+		{ \
+			if (i < j) \
+			{ \
+				type tmp_r = (p)[2 * i]; \
+				type tmp_i = (p)[2 * i + 1]; \
+				(p)[2 * i] = (p)[2 * j]; \
+				(p)[2 * i + 1] = (p)[2 * j + 1]; \
+				(p)[2 * j] = tmp_r; \
+				(p)[2 * j + 1] = tmp_i; \
+			} \
+			uint32_t bit = (len) >> 1; \
+			while (j & bit) \
+			{ \
+				j ^= bit; \
+				bit >>= 1; \
+			} \
+			j |= bit; \
+		} \
+	} while (0)
+
+arm_status arm_cfft_init_q15(arm_cfft_instance_q15* S, uint16_t fftLen)
+{
+	if (S == NULL) return ARM_MATH_ARGUMENT_ERROR;
+	if ((fftLen < 16) || (fftLen > HOST_FFT_MAX_LEN) || !is_power_of_two(fftLen)) return ARM_MATH_ARGUMENT_ERROR;
+
+	S->fftLen = fftLen;
+	S->pTwiddle = twiddle_stage_q15(fftLen);
+	S->pBitRevTable = NULL;
+	S->bitRevLength = 0;
+
+	return ARM_MATH_SUCCESS;
+}
+
+void arm_cfft_q15(const arm_cfft_instance_q15* S, q15_t* p1, uint8_t ifftFlag, uint8_t bitReverseFlag)
+{
+	const uint32_t len = S->fftLen;
+
+	if (ifftFlag)
+	{
+		for (uint32_t i = 0; i < len; ++i) p1[2 * i + 1] = saturate_q15(-(int32_t)p1[2 * i + 1]);
+	}
+
+	// Radix-2 decimation in frequency, inputs of each butterfly are divided by 2 to avoid overflow
+	for (uint32_t span = len; span >= 2; span >>= 1)
+	{
+		const uint32_t half = span / 2;
+		const q15_t* w = S->pTwiddle + 2 * (len - span);
+
+		for (uint32_t group = 0; group < len; group += span)
+		{
+			q15_t* a = &p1[2 * group];
+			q15_t* b = a + 2 * half;
+			for (uint32_t j = 0; j < half; ++j)
+			{
+				const int32_t ar = a[2 * j] >> 1;
+				const int32_t ai = a[2 * j + 1] >> 1;
+				const int32_t br = b[2 * j] >> 1;
+				const int32_t bi = b[2 * j + 1] >> 1;
+				const int32_t dr = ar - br;
+				const int32_t di = ai - bi;
+
+				a[2 * j] = saturate_q15(ar + br);
+				a[2 * j + 1] = saturate_q15(ai + bi);
+				b[2 * j] = saturate_q15((dr * w[2 * j] - di * w[2 * j + 1]) >> 15);
+				b[2 * j + 1] = saturate_q15((dr * w[2 * j + 1] + di * w[2 * j]) >> 15);
+			}
+		}
+	}
+
+	if (bitReverseFlag) HOST_BIT_REVERSE(q15_t, p1, len);
+
+	if (ifftFlag)
+	{
+		for (uint32_t i = 0; i < len; ++i) p1[2 * i + 1] = saturate_q15(-(int32_t)p1[2 * i + 1]);
+	}
+}
+
+arm_status arm_cfft_init_q31(arm_cfft_instance_q31* S, uint16_t fftLen)
+{
+	if (S == NULL) return ARM_MATH_ARGUMENT_ERROR;
+	if ((fftLen < 16) || (fftLen > HOST_FFT_MAX_LEN) || !is_power_of_two(fftLen)) return ARM_MATH_ARGUMENT_ERROR;
+
+	S->fftLen = fftLen;
+	S->pTwiddle = twiddle_stage_q31(fftLen);
+	S->pBitRevTable = NULL;
+	S->bitRevLength = 0;
+
+	return ARM_MATH_SUCCESS;
+}
+
+void arm_cfft_q31(const arm_cfft_instance_q31* S, q31_t* p1, uint8_t ifftFlag, uint8_t bitReverseFlag)
+{
+	const uint32_t len = S->fftLen;
+
+	if (ifftFlag)
+	{
+		for (uint32_t i = 0; i < len; ++i) p1[2 * i + 1] = saturate_q31(-(int64_t)p1[2 * i + 1]);
+	}
+
+	for (uint32_t span = len; span >= 2; span >>= 1)
+	{
+		const uint32_t half = span / 2;
+		const q31_t* w = S->pTwiddle + 2 * (len - span);
+
+		for (uint32_t group = 0; group < len; group += span)
+		{
+			q31_t* a = &p1[2 * group];
+			q31_t* b = a + 2 * half;
+			for (uint32_t j = 0; j < half; ++j)
+			{
+				const int64_t ar = a[2 * j] >> 1;
+				const int64_t ai = a[2 * j + 1] >> 1;
+				const int64_t br = b[2 * j] >> 1;
+				const int64_t bi = b[2 * j + 1] >> 1;
+				const int64_t dr = ar - br;
+				const int64_t di = ai - bi;
+
+				a[2 * j] = saturate_q31(ar + br);
+				a[2 * j + 1] = saturate_q31(ai + bi);
+				b[2 * j] = saturate_q31((dr * w[2 * j] - di * w[2 * j + 1]) >> 31);
+				b[2 * j + 1] = saturate_q31((dr * w[2 * j + 1] + di * w[2 * j]) >> 31);
+			}
+		}
+	}
+
+	if (bitReverseFlag) HOST_BIT_REVERSE(q31_t, p1, len);
+
+	if (ifftFlag)
+	{
+		for (uint32_t i = 0; i < len; ++i) p1[2 * i + 1] = saturate_q31(-(int64_t)p1[2 * i + 1]);
+	}
+}
+
+static void cfft_q15_instances_init(void)
+{
+	for (uint32_t log2_len = 4; log2_len < 13; ++log2_len)
+	{
+		arm_cfft_init_q15(&cfft_q15_instances[log2_len], (uint16_t)(1U << log2_len));
+	}
+}
+
+static pthread_once_t cfft_q15_once = PTHREAD_ONCE_INIT;
+
+arm_status arm_rfft_init_q15(arm_rfft_instance_q15* S, uint32_t fftLenReal, uint32_t ifftFlagR, uint32_t bitReverseFlag)
+{
+	if (S == NULL) return ARM_MATH_ARGUMENT_ERROR;
+	if ((fftLenReal < 32) || (fftLenReal > HOST_FFT_MAX_LEN) || !is_power_of_two(fftLenReal)) return ARM_MATH_ARGUMENT_ERROR;
+	if (ifftFlagR != 0) return ARM_MATH_ARGUMENT_ERROR;
+
+	pthread_once(&cfft_q15_once, cfft_q15_instances_init);
+
+	uint32_t log2_len = 0;
+	while ((1U << log2_len) < (fftLenReal / 2)) log2_len++;
+
+	S->fftLenReal = fftLenReal;
+	S->ifftFlagR = (uint8_t)ifftFlagR;
+	S->bitReverseFlagR = (uint8_t)bitReverseFlag;
+	S->twidCoefRModifier = HOST_FFT_MAX_LEN / fftLenReal;
+	S->pTwiddleAReal = twiddle_stage_q15(fftLenReal);
+	S->pTwiddleBReal = NULL;
+	S->pCfft = &cfft_q15_instances[log2_len];
+
+	return ARM_MATH_SUCCESS;
+}
+
+void arm_rfft_q15(const arm_rfft_instance_q15* S, q15_t* pSrc, q15_t* pDst)
+{
+	const uint32_t len = S->fftLenReal;
+	const uint32_t half = len / 2;
+	const q15_t* w = S->pTwiddleAReal;
+
+	// Complex FFT of z[n] = x[2n] + i.x[2n+1] (downscaled by len / 2)
+	arm_cfft_q15(S->pCfft, pSrc, 0, 1);
+
+	// Split, see arm_rfft_fast_f32
+	pDst[0] = saturate_q15((int32_t)pSrc[0] + pSrc[1]);
+	pDst[1] = 0;
+	pDst[len] = saturate_q15((int32_t)pSrc[0] - pSrc[1]);
+	pDst[len + 1] = 0;
+
+	for (uint32_t k = 1; k < half; ++k)
+	{
+		const int32_t zr = pSrc[2 * k];
+		const int32_t zi = pSrc[2 * k + 1];
+		const int32_t cr = pSrc[2 * (half - k)];
+		const int32_t ci = -pSrc[2 * (half - k) + 1];
+
+		// Values multiplied by 2 (not divided), the division by 2 is done on the final result
+		const int32_t er = zr + cr;
+		const int32_t ei = zi + ci;
+		const int32_t odd_r = zi - ci;
+		const int32_t odd_i = -(zr - cr);
+
+		const int32_t wr = w[2 * k];
+		const int32_t wi = w[2 * k + 1];
+
+		const int32_t xr = (er + ((odd_r * wr - odd_i * wi) >> 15)) >> 1;
+		const int32_t xi = (ei + ((odd_r * wi + odd_i * wr) >> 15)) >> 1;
+
+		pDst[2 * k] = saturate_q15(xr);
+		pDst[2 * k + 1] = saturate_q15(xi);
+
+		// Conjugate symmetric part
+		pDst[2 * (len - k)] = saturate_q15(xr);
+		pDst[2 * (len - k) + 1] = saturate_q15(-xi);
+	}
+}
+
+void arm_mult_f32(const float32_t* pSrcA, const float32_t* pSrcB, float32_t* pDst, uint32_t blockSize)
+{
+	uint32_t i = 0;
+
+#if defined(__AVX__)
+	for (; i + 8 <= blockSize; i += 8)
+	{
+		_mm256_storeu_ps(&pDst[i], _mm256_mul_ps(_mm256_loadu_ps(&pSrcA[i]), _mm256_loadu_ps(&pSrcB[i])));
+	}
+#endif
+
+#if defined(__SSE3__)
+	for (; i + 4 <= blockSize; i += 4)
+	{
+		_mm_storeu_ps(&pDst[i], _mm_mul_ps(_mm_loadu_ps(&pSrcA[i]), _mm_loadu_ps(&pSrcB[i])));
+	}
+#endif
+
+	for (; i < blockSize; ++i)
+	{
+		pDst[i] = pSrcA[i] * pSrcB[i];
+	}
+}
+
+void arm_cmplx_mult_real_f32(const float32_t* pSrcCmplx, const float32_t* pSrcReal, float32_t* pCmplxDst, uint32_t numSamples)
+{
+	uint32_t i = 0;
+
+#if defined(__AVX__)
+	for (; i + 4 <= numSamples; i += 4)
+	{
+		// [r0 r1 r2 r3] -> [r0 r0 r1 r1 r2 r2 r3 r3]
+		__m128 real = _mm_loadu_ps(&pSrcReal[i]);
+		__m256 duplicated = _mm256_set_m128(_mm_unpackhi_ps(real, real), _mm_unpacklo_ps(real, real));
+		_mm256_storeu_ps(&pCmplxDst[2 * i], _mm256_mul_ps(_mm256_loadu_ps(&pSrcCmplx[2 * i]), duplicated));
+	}
+#endif
+
+#if defined(__SSE3__)
+	for (; i + 2 <= numSamples; i += 2)
+	{
+		__m128 real = _mm_castpd_ps(_mm_load_sd((const double*)&pSrcReal[i]));
+		__m128 duplicated = _mm_unpacklo_ps(real, real);
+		_mm_storeu_ps(&pCmplxDst[2 * i], _mm_mul_ps(_mm_loadu_ps(&pSrcCmplx[2 * i]), duplicated));
+	}
+#endif
+
+	for (; i < numSamples; ++i)
+	{
+		pCmplxDst[2 * i] = pSrcCmplx[2 * i] * pSrcReal[i];
+		pCmplxDst[2 * i + 1] = pSrcCmplx[2 * i + 1] * pSrcReal[i];
+	}
+}
+
+void arm_cmplx_mag_squared_f32(const float32_t* pSrc, float32_t* pDst, uint32_t numSamples)
+{
+	uint32_t i = 0;
+
+#if defined(__AVX__)
+	for (; i + 8 <= numSamples; i += 8)
+	{
+		__m256 a = _mm256_loadu_ps(&pSrc[2 * i]);
+		__m256 b = _mm256_loadu_ps(&pSrc[2 * i + 8]);
+		// [m0 m1 m4 m5 | m2 m3 m6 m7] -> [m0 m1 m2 m3 | m4 m5 m6 m7]
+		__m256 sum = _mm256_hadd_ps(_mm256_mul_ps(a, a), _mm256_mul_ps(b, b));
+		__m128 low = _mm256_castps256_ps128(sum);
+		__m128 high = _mm256_extractf128_ps(sum, 1);
+		_mm256_storeu_ps(&pDst[i], _mm256_set_m128(_mm_shuffle_ps(low, high, _MM_SHUFFLE(3, 2, 3, 2)),
+				_mm_shuffle_ps(low, high, _MM_SHUFFLE(1, 0, 1, 0))));
+	}
+#endif
+
+#if defined(__SSE3__)
+	for (; i + 4 <= numSamples; i += 4)
+	{
+		__m128 a = _mm_loadu_ps(&pSrc[2 * i]);
+		__m128 b = _mm_loadu_ps(&pSrc[2 * i + 4]);
+		_mm_storeu_ps(&pDst[i], _mm_hadd_ps(_mm_mul_ps(a, a), _mm_mul_ps(b, b)));
+	}
+#endif
+
+	for (; i < numSamples; ++i)
+	{
+		pDst[i] = (pSrc[2 * i] * pSrc[2 * i]) + (pSrc[2 * i + 1] * pSrc[2 * i + 1]);
+	}
+}
+
+void arm_max_f32(const float32_t* pSrc, uint32_t blockSize, float32_t* pResult, uint32_t* pIndex)
+{
+	if (blockSize == 0)
+	{
+		*pResult = 0.0f;
+		*pIndex = 0;
+		return;
+	}
+
+	// Maximum value (vectorized reduction), then index of its first occurrence
+	uint32_t i = 0;
+	float32_t max = pSrc[0];
+
+#if defined(__AVX__)
+	if (blockSize >= 8)
+	{
+		__m256 max8 = _mm256_loadu_ps(pSrc);
+		for (i = 8; i + 8 <= blockSize; i += 8)
+		{
+			max8 = _mm256_max_ps(max8, _mm256_loadu_ps(&pSrc[i]));
+		}
+		__m128 max4 = _mm_max_ps(_mm256_castps256_ps128(max8), _mm256_extractf128_ps(max8, 1));
+		max4 = _mm_max_ps(max4, _mm_movehl_ps(max4, max4));
+		max4 = _mm_max_ss(max4, _mm_shuffle_ps(max4, max4, _MM_SHUFFLE(1, 1, 1, 1)));
+		max = _mm_cvtss_f32(max4);
+	}
+#elif defined(__SSE3__)
+	if (blockSize >= 4)
+	{
+		__m128 max4 = _mm_loadu_ps(pSrc);
+		for (i = 4; i + 4 <= blockSize; i += 4)
+		{
+			max4 = _mm_max_ps(max4, _mm_loadu_ps(&pSrc[i]));
+		}
+		max4 = _mm_max_ps(max4, _mm_movehl_ps(max4, max4));
+		max4 = _mm_max_ss(max4, _mm_shuffle_ps(max4, max4, _MM_SHUFFLE(1, 1, 1, 1)));
+		max = _mm_cvtss_f32(max4);
+	}
+#endif
+
+	for (; i < blockSize; ++i)
+	{
+		if (pSrc[i] > max) max = pSrc[i];
+	}
+
+	uint32_t index = 0;
+	while ((index < blockSize) && (pSrc[index] != max)) index++;
+
+	*pResult = max;
+	*pIndex = index;
+}
+
+arm_status arm_sqrt_f32(float32_t in, float32_t* pOut)
+{
+	if (in >= 0.0f)
+	{
+		*pOut = sqrtf(in);
+		return ARM_MATH_SUCCESS;
+	}
+
+	*pOut = 0.0f;
+	return ARM_MATH_ARGUMENT_ERROR;
+}
+
+/**
+ * Sum of len floats (vectorized reduction)
+ */
+static float32_t sum_f32(const float32_t* buffer, uint32_t len)
+{
+	uint32_t i = 0;
+	float32_t sum = 0;
+
+#if defined(__SSE3__)
+	__m128 acc = _mm_setzero_ps();
+	for (; i + 4 <= len; i += 4)
+	{
+		acc = _mm_add_ps(acc, _mm_loadu_ps(&buffer[i]));
+	}
+	acc = _mm_hadd_ps(acc, acc);
+	acc = _mm_hadd_ps(acc, acc);
+	sum = _mm_cvtss_f32(acc);
+#endif
+
+	for (; i < len; ++i)
+	{
+		sum += buffer[i];
+	}
+	return sum;
+}
+
+/**
+ * buffer[i] -= offset[i % 2] for i = 0 to len - 1 (len is a multiple of 2)
+ */
+static void subtract_pair_f32(float32_t* buffer, uint32_t len, float32_t offset_even, float32_t offset_odd)
+{
+	uint32_t i = 0;
+
+#if defined(__AVX__)
+	const __m256 offset8 = _mm256_setr_ps(offset_even, offset_odd, offset_even, offset_odd, offset_even, offset_odd, offset_even, offset_odd);
+	for (; i + 8 <= len; i += 8)
+	{
+		_mm256_storeu_ps(&buffer[i], _mm256_sub_ps(_mm256_loadu_ps(&buffer[i]), offset8));
+	}
+#endif
+
+#if defined(__SSE3__)
+	const __m128 offset4 = _mm_setr_ps(offset_even, offset_odd, offset_even, offset_odd);
+	for (; i + 4 <= len; i += 4)
+	{
+		_mm_storeu_ps(&buffer[i], _mm_sub_ps(_mm_loadu_ps(&buffer[i]), offset4));
+	}
+#endif
+
+	for (; i < len; i += 2)
+	{
+		buffer[i] -= offset_even;
+		buffer[i + 1] -= offset_odd;
+	}
+}
+
+void ifx_mean_removal_f32(float32_t* buffer, uint32_t len)
+{
+	if (len == 0) return;
+
+	const float32_t mean = sum_f32(buffer, len) / (float32_t)len;
+
+	uint32_t even_len = len & ~1U;
+	subtract_pair_f32(buffer, even_len, mean, mean);
+	if (even_len != len) buffer[len - 1] -= mean;
+}
+
+void ifx_cmplx_mean_removal_f32(cfloat32_t* buffer, uint32_t len)
+{
+	if (len == 0) return;
+
+	float32_t* values = (float32_t*)buffer;
+	float32_t real = 0;
+	float32_t imag = 0;
+	for (uint32_t i = 0; i < len; ++i)
+	{
+		real += values[2 * i];
+		imag += values[2 * i + 1];
+	}
+
+	subtract_pair_f32(values, 2 * len, real / (float32_t)len, imag / (float32_t)len);
+}
+
+void ifx_window_blackmanharris_f32(float32_t* win, uint32_t len)
+{
+	if (len == 0) return;
+	if (len == 1)
+	{
+		win[0] = 1.0f;
+		return;
+	}
+
+	const double a0 = 0.35875;
+	const double a1 = 0.48829;
+	const double a2 = 0.14128;
+	const double a3 = 0.01168;
+
+	for (uint32_t i = 0; i < len; ++i)
+	{
+		const double phase = 2.0 * M_PI * (double)i / (double)(len - 1);
+		win[i] = (float32_t)(a0 - a1 * cos(phase) + a2 * cos(2.0 * phase) - a3 * cos(3.0 * phase));
+	}
+}
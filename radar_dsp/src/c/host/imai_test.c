@@ -0,0 +1,191 @@
+/*
+ * imai_test.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ * Host (x86 / Linux) check of model.c with the mtb_ml host interpreter against the test vectors exported
+ * by DEEPCRAFT Studio with the model (see Makefile, make test):
+ *
+ *   ./imai_test <..._preprocessor_and_network_test_input.data> <..._preprocessor_and_network_test_output.data>
+ *
+ * The input rows are given to IMAI_enqueue, each output of IMAI_dequeue is compared with the next row of the
+ * expected output (pred_ columns). The values of the export are in the order of the model outputs,
+ * but the columns are not named after IMAI_DATA_OUT_SYMBOLS (e.g. the first output, "unlabelled", is named pred_click):
+ * the columns are therefore matched by position.
+ * model.c must be built with IMAI_RNN_RESYNC_WINDOWS (default): the reference evaluates every window on its own.
+ *
+ * Rutronik Elektronische Bauelemente GmbH Disclaimer: The evaluation board
+ * including the software is for testing purposes only and,
+ * because it has limited functions and limited resilience, is not suitable
+ * for permanent use under real conditions. If the evaluation board is
+ * nevertheless used under real conditions, this is done at one’s responsibility;
+ * any liability of Rutronik is insofar excluded
+ */
+
+#include "model.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Expected outputs are exported with 5 decimals
+ */
+#define IMAI_TEST_TOLERANCE 2e-5f
+
+#define IMAI_TEST_LINE_LEN 1024
+#define IMAI_TEST_MAX_COLUMNS 16
+
+/**
+ * @brief Split a CSV line in place
+ *
+ * @retval Number of fields
+ */
+static int csv_split(char* line, char** fields, int max_fields)
+{
+	int count = 0;
+	char* field = line;
+
+	while ((field != NULL) && (count < max_fields))
+	{
+		char* next = strchr(field, ',');
+		if (next != NULL) *next++ = '\0';
+
+		// Trim spaces and end of line
+		while (*field == ' ') field++;
+		char* end = field + strlen(field);
+		while ((end > field) && ((end[-1] == '\n') || (end[-1] == '\r') || (end[-1] == ' '))) *--end = '\0';
+
+		fields[count++] = field;
+		field = next;
+	}
+
+	return count;
+}
+
+/**
+ * @brief Read the next data line of a CSV file, first column (time) skipped
+ *
+ * @retval Number of values read, -1 at the end of the file
+ */
+static int csv_read_values(FILE* file, float* values, int max_values)
+{
+	char line[IMAI_TEST_LINE_LEN];
+	char* fields[IMAI_TEST_MAX_COLUMNS];
+
+	if (fgets(line, sizeof(line), file) == NULL) return -1;
+
+	const int count = csv_split(line, fields, IMAI_TEST_MAX_COLUMNS);
+	int value_count = 0;
+	for (int i = 1; (i < count) && (value_count < max_values); ++i)
+	{
+		values[value_count++] = strtof(fields[i], NULL);
+	}
+
+	return value_count;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc != 3)
+	{
+		fprintf(stderr, "usage: %s <test_input.data> <test_output.data>\n", argv[0]);
+		return 2;
+	}
+
+	FILE* input = fopen(argv[1], "r");
+	FILE* output = fopen(argv[2], "r");
+	if ((input == NULL) || (output == NULL))
+	{
+		fprintf(stderr, "cannot open the test vectors\n");
+		return 2;
+	}
+
+	// Column of each output in the expected output (time skipped)
+	static const char* symbols[IMAI_DATA_OUT_COUNT] = IMAI_DATA_OUT_SYMBOLS;
+	int column[IMAI_DATA_OUT_COUNT];
+	int column_count = 0;
+	char line[IMAI_TEST_LINE_LEN];
+	char* fields[IMAI_TEST_MAX_COLUMNS];
+	char header[IMAI_TEST_LINE_LEN];
+
+	if ((fgets(line, sizeof(line), input) == NULL) || (fgets(header, sizeof(header), output) == NULL))
+	{
+		fprintf(stderr, "empty test vectors\n");
+		return 2;
+	}
+	const int field_count = csv_split(header, fields, IMAI_TEST_MAX_COLUMNS);
+	for (int j = 1; j < field_count; ++j)
+	{
+		if ((strncmp(fields[j], "pred_", 5) == 0) && (column_count < IMAI_DATA_OUT_COUNT)) column[column_count++] = j - 1;
+	}
+	if (column_count != IMAI_DATA_OUT_COUNT)
+	{
+		fprintf(stderr, "%s: %d pred_ columns, %d outputs\n", argv[2], column_count, IMAI_DATA_OUT_COUNT);
+		return 2;
+	}
+
+	if (IMAI_init() != 0)
+	{
+		fprintf(stderr, "IMAI_init failed\n");
+		return 1;
+	}
+
+	float data_in[IMAI_DATA_IN_COUNT];
+	float data_out[IMAI_DATA_OUT_COUNT];
+	float expected[IMAI_TEST_MAX_COLUMNS];
+	int inputs = 0;
+	int windows = 0;
+	int failures = 0;
+	float max_error = 0;
+	bool expected_end = false;
+
+	while (csv_read_values(input, data_in, IMAI_DATA_IN_COUNT) == IMAI_DATA_IN_COUNT)
+	{
+		if (IMAI_enqueue(data_in) != 0)
+		{
+			fprintf(stderr, "IMAI_enqueue failed, input %d\n", inputs);
+			return 1;
+		}
+		inputs++;
+
+		while (IMAI_dequeue(data_out) == 0)
+		{
+			// The last windows of the input may not be in the reference
+			if (expected_end || (csv_read_values(output, expected, IMAI_TEST_MAX_COLUMNS) < 0))
+			{
+				expected_end = true;
+				continue;
+			}
+
+			for (int i = 0; i < IMAI_DATA_OUT_COUNT; ++i)
+			{
+				const float error = fabsf(data_out[i] - expected[column[i]]);
+				if (error > max_error) max_error = error;
+				if (error > IMAI_TEST_TOLERANCE)
+				{
+					if (failures < 10)
+					{
+						printf("window %d, %s: %.5f expected %.5f\n", windows, symbols[i], data_out[i], expected[column[i]]);
+					}
+					failures++;
+				}
+			}
+			windows++;
+		}
+	}
+
+	// Every expected output must have been produced
+	const bool missing = !expected_end && (csv_read_values(output, expected, IMAI_TEST_MAX_COLUMNS) >= 0);
+
+	IMAI_finalize();
+	fclose(input);
+	fclose(output);
+
+	printf("%d inputs, %d windows compared, maximum error %.2e\n", inputs, windows, max_error);
+	if (missing) printf("FAILED: fewer windows than expected outputs\n");
+	if (failures != 0) printf("FAILED: %d values above %.0e\n", failures, IMAI_TEST_TOLERANCE);
+
+	return (missing || (failures != 0)) ? 1 : 0;
+}
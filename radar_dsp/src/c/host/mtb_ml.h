@@ -0,0 +1,47 @@
+/*
+ * mtb_ml.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ * Host (x86 / Linux) replacement of the ModusToolbox ml-middleware subset used by the DEEPCRAFT generated model.c
+ * (mtb_ml_*), so model.c compiles unchanged and runs the same embedded TensorFlow Lite model on a PC, e.g.:
+ *
+ *   gcc -O3 -march=native -DCOMPONENT_ML_TFLM -DCOMPONENT_ML_FLOAT32 -Ihost -I. host/mtb_ml_host.c model.c app.c -lm
+ *
+ * The model binary is interpreted by mtb_ml_host.c: float32 models, operators RESHAPE, CONV_2D, MAX_POOL_2D,
+ * AVERAGE_POOL_2D, FULLY_CONNECTED, UNIDIRECTIONAL_SEQUENCE_LSTM, MEAN, SOFTMAX, LOGISTIC, TANH, RELU.
+ * Other operators are reported by mtb_ml_model_init. As with TensorFlow Lite Micro, activations, variables and
+ * scratch buffers are planned inside of the tensor arena given by the caller (weights are read from the binary),
+ * and variable tensors (LSTM state) are kept from one run to the next.
+ * Results match the target within float rounding tolerance, make test checks model.c against the test vectors
+ * exported with the model (imai_test.c).
+ *
+ * Latency and throughput: define IMAI_PROFILING and call IMAI_mtb_models_profile_log(), the time of each
+ * run (and of each operator with MTB_ML_PROFILE_ENABLE_LAYER) is measured with the monotonic clock.
+ *
+ * Rutronik Elektronische Bauelemente GmbH Disclaimer: The evaluation board
+ * including the software is for testing purposes only and,
+ * because it has limited functions and limited resilience, is not suitable
+ * for permanent use under real conditions. If the evaluation board is
+ * nevertheless used under real conditions, this is done at one’s responsibility;
+ * any liability of Rutronik is insofar excluded
+ */
+
+#ifndef HOST_MTB_ML_H_
+#define HOST_MTB_ML_H_
+
+#include "mtb_ml_common.h"
+#include "mtb_ml_model.h"
+#include "mtb_ml_utils.h"
+
+/**
+ * @brief Initialize the middleware (no NPU on the host, the priority is ignored)
+ */
+cy_rslt_t mtb_ml_init(int npu_priority);
+
+/**
+ * @brief Release the middleware
+ */
+cy_rslt_t mtb_ml_deinit(void);
+
+#endif /* HOST_MTB_ML_H_ */
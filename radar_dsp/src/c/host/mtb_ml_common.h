@@ -0,0 +1,41 @@
+/*
+ * mtb_ml_common.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ * Host (x86 / Linux) replacement of the ModusToolbox ml-middleware: types and result codes (see mtb_ml.h)
+ *
+ * Rutronik Elektronische Bauelemente GmbH Disclaimer: The evaluation board
+ * including the software is for testing purposes only and,
+ * because it has limited functions and limited resilience, is not suitable
+ * for permanent use under real conditions. If the evaluation board is
+ * nevertheless used under real conditions, this is done at one’s responsibility;
+ * any liability of Rutronik is insofar excluded
+ */
+
+#ifndef HOST_MTB_ML_COMMON_H_
+#define HOST_MTB_ML_COMMON_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef uint32_t cy_rslt_t;
+
+#define CY_RSLT_SUCCESS						((cy_rslt_t)0U)
+
+#define MTB_ML_RESULT_SUCCESS				CY_RSLT_SUCCESS
+#define MTB_ML_RESULT_BAD_ARG				((cy_rslt_t)1U)
+#define MTB_ML_RESULT_ALLOC_ERR				((cy_rslt_t)2U)
+#define MTB_ML_RESULT_BAD_MODEL				((cy_rslt_t)3U)
+#define MTB_ML_RESULT_MISMATCH_DATA_TYPE	((cy_rslt_t)4U)
+#define MTB_ML_RESULT_INPUT_ERROR			((cy_rslt_t)5U)
+
+/**
+ * Only float32 models are supported (COMPONENT_ML_FLOAT32)
+ */
+typedef float MTB_ML_DATA_T;
+
+#define MTB_ML_MODEL_NAME_LEN 32
+
+#endif /* HOST_MTB_ML_COMMON_H_ */
@@ -0,0 +1,1351 @@
+/*
+ * mtb_ml_host.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ * Host implementation of the ml-middleware subset (see mtb_ml.h): float32 TensorFlow Lite interpreter
+ *
+ * Rutronik Elektronische Bauelemente GmbH Disclaimer: The evaluation board
+ * including the software is for testing purposes only and,
+ * because it has limited functions and limited resilience, is not suitable
+ * for permanent use under real conditions. If the evaluation board is
+ * nevertheless used under real conditions, this is done at one’s responsibility;
+ * any liability of Rutronik is insofar excluded
+ */
+
+// clock_gettime
+#define _POSIX_C_SOURCE 200112L
+
+#include "mtb_ml.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+/**
+ * Builtin operator codes (TensorFlow Lite schema)
+ */
+#define OP_AVERAGE_POOL_2D					1U
+#define OP_CONV_2D							3U
+#define OP_FULLY_CONNECTED					9U
+#define OP_LOGISTIC							14U
+#define OP_MAX_POOL_2D						17U
+#define OP_RELU								19U
+#define OP_RESHAPE							22U
+#define OP_SOFTMAX							25U
+#define OP_TANH								28U
+#define OP_MEAN								40U
+#define OP_UNIDIRECTIONAL_SEQUENCE_LSTM		44U
+
+/**
+ * Tensor types, fused activations and paddings (TensorFlow Lite schema)
+ */
+#define TYPE_FLOAT32		0U
+#define TYPE_INT32			2U
+
+#define ACTIVATION_NONE		0U
+#define ACTIVATION_RELU		1U
+#define ACTIVATION_RELU_N1_TO_1	2U
+#define ACTIVATION_RELU6	3U
+#define ACTIVATION_TANH		4U
+
+#define PADDING_SAME		0U
+#define PADDING_VALID		1U
+
+#define MAX_DIMS			4U
+#define MAX_OP_INPUTS		24U
+
+/**
+ * Tensors are placed inside of the arena with this alignment (bytes)
+ */
+#define ARENA_ALIGNMENT		16U
+
+/**
+ * Indexes of the UNIDIRECTIONAL_SEQUENCE_LSTM inputs
+ */
+#define LSTM_INPUT					0U
+#define LSTM_INPUT_TO_GATE			1U		/**< Input, forget, cell, output gates: 1 to 4 */
+#define LSTM_RECURRENT_TO_GATE		5U		/**< 5 to 8 */
+#define LSTM_CELL_TO_GATE			9U		/**< Peephole, 9 to 11 */
+#define LSTM_GATE_BIAS				12U		/**< 12 to 15 */
+#define LSTM_PROJECTION_WEIGHTS		16U
+#define LSTM_PROJECTION_BIAS		17U
+#define LSTM_OUTPUT_STATE			18U
+#define LSTM_CELL_STATE				19U
+#define LSTM_LAYER_NORM				20U		/**< 20 to 23 */
+
+/**
+ * Read only view of the flatbuffer, offsets out of the buffer read as absent fields
+ */
+typedef struct
+{
+	const uint8_t* data;
+	uint32_t size;
+} flatbuffer_t;
+
+typedef struct
+{
+	void* data;						/**< Inside of the model binary (constant) or of the arena */
+	int32_t shape[MAX_DIMS];
+	uint32_t dims;
+	uint32_t count;					/**< Elements */
+	uint32_t type;
+	bool constant;
+	bool variable;
+
+	int32_t first_use;				/**< Operators writing / reading the tensor (memory planning), -1 -> not used */
+	int32_t last_use;
+	uint32_t arena_offset;
+} host_tensor_t;
+
+typedef struct
+{
+	uint32_t code;
+	int32_t inputs[MAX_OP_INPUTS];	/**< -1 -> optional input not given */
+	uint32_t input_count;
+	int32_t output;
+	int32_t scratch;				/**< Tensor used as scratch memory during the operator (or -1) */
+
+	uint32_t activation;
+	uint32_t padding;
+	int32_t stride_w, stride_h;
+	int32_t dilation_w, dilation_h;
+	int32_t filter_w, filter_h;
+	int32_t pad_w, pad_h;
+	float beta;						/**< SOFTMAX */
+	float cell_clip;				/**< LSTM */
+	bool time_major;				/**< LSTM */
+
+	uint64_t profile_time;			/**< Sum of the time spent in the operator since the profiling was configured */
+	uint64_t profile_last;
+} host_operator_t;
+
+/**
+ * Interpreter: the public object comes first, mtb_ml_model_t* and host_model_t* are interchangeable
+ */
+typedef struct
+{
+	mtb_ml_model_t object;
+
+	flatbuffer_t fb;
+	host_tensor_t* tensors;
+	uint32_t tensor_count;			/**< Tensors of the model + scratch tensors */
+	host_operator_t* operators;
+	uint32_t operator_count;
+	int32_t input;
+	int32_t output;
+
+	uint8_t* arena;
+	uint32_t arena_size;
+} host_model_t;
+
+/*
+ * Flatbuffer access
+ */
+
+static uint32_t fb_u32(const flatbuffer_t* fb, uint32_t offset)
+{
+	uint32_t value = 0;
+	if (offset <= fb->size - 4U) memcpy(&value, fb->data + offset, sizeof(value));
+	return value;
+}
+
+static uint16_t fb_u16(const flatbuffer_t* fb, uint32_t offset)
+{
+	uint16_t value = 0;
+	if (offset <= fb->size - 2U) memcpy(&value, fb->data + offset, sizeof(value));
+	return value;
+}
+
+/**
+ * @brief Follow an offset stored at position offset
+ *
+ * @retval Target position
+ * @retval 0	Out of the buffer
+ */
+static uint32_t fb_deref(const flatbuffer_t* fb, uint32_t offset)
+{
+	const uint32_t relative = fb_u32(fb, offset);
+	if ((relative == 0) || (offset > fb->size - 4U) || (relative > fb->size - 4U - offset)) return 0;
+	return offset + relative;
+}
+
+/**
+ * @brief Position of a field of a table
+ *
+ * @retval Position
+ * @retval 0	Field absent (default value)
+ */
+static uint32_t fb_field(const flatbuffer_t* fb, uint32_t table, uint32_t field)
+{
+	if (table == 0) return 0;
+
+	int32_t vtable_offset;
+	const uint32_t raw = fb_u32(fb, table);
+	memcpy(&vtable_offset, &raw, sizeof(vtable_offset));
+
+	const int64_t vtable = (int64_t)table - vtable_offset;
+	if ((vtable < 4) || (vtable > (int64_t)fb->size - 4)) return 0;
+
+	const uint16_t vtable_size = fb_u16(fb, (uint32_t)vtable);
+	const uint32_t entry = 4U + 2U * field;
+	if (entry + 2U > vtable_size) return 0;
+
+	const uint16_t position = fb_u16(fb, (uint32_t)vtable + entry);
+	return (position == 0) ? 0 : table + position;
+}
+
+static uint32_t fb_field_u32(const flatbuffer_t* fb, uint32_t table, uint32_t field, uint32_t default_value)
+{
+	const uint32_t position = fb_field(fb, table, field);
+	return (position == 0) ? default_value : fb_u32(fb, position);
+}
+
+static int32_t fb_field_i32(const flatbuffer_t* fb, uint32_t table, uint32_t field, int32_t default_value)
+{
+	const uint32_t raw = fb_field_u32(fb, table, field, (uint32_t)default_value);
+	int32_t value;
+	memcpy(&value, &raw, sizeof(value));
+	return value;
+}
+
+static uint8_t fb_field_u8(const flatbuffer_t* fb, uint32_t table, uint32_t field, uint8_t default_value)
+{
+	const uint32_t position = fb_field(fb, table, field);
+	return ((position == 0) || (position >= fb->size)) ? default_value : fb->data[position];
+}
+
+static float fb_field_f32(const flatbuffer_t* fb, uint32_t table, uint32_t field, float default_value)
+{
+	const uint32_t position = fb_field(fb, table, field);
+	if (position == 0) return default_value;
+
+	const uint32_t raw = fb_u32(fb, position);
+	float value;
+	memcpy(&value, &raw, sizeof(value));
+	return value;
+}
+
+/**
+ * @brief Table referenced by a field
+ *
+ * @retval Position of the table
+ * @retval 0	Field absent
+ */
+static uint32_t fb_field_table(const flatbuffer_t* fb, uint32_t table, uint32_t field)
+{
+	const uint32_t position = fb_field(fb, table, field);
+	return (position == 0) ? 0 : fb_deref(fb, position);
+}
+
+/**
+ * @brief Vector referenced by a field
+ *
+ * @param [out] length	Number of elements (0 if absent)
+ * @param [in] element_size	Bytes per element (bounds check)
+ *
+ * @retval Position of the first element
+ * @retval 0	Field absent
+ */
+static uint32_t fb_field_vector(const flatbuffer_t* fb, uint32_t table, uint32_t field, uint32_t element_size, uint32_t* length)
+{
+	*length = 0;
+
+	const uint32_t vector = fb_field_table(fb, table, field);
+	if (vector == 0) return 0;
+
+	const uint32_t count = fb_u32(fb, vector);
+	if ((uint64_t)count * element_size > (uint64_t)(fb->size - vector - 4U)) return 0;
+
+	*length = count;
+	return vector + 4U;
+}
+
+/**
+ * @brief Table number index of a vector of tables
+ */
+static uint32_t fb_vector_table(const flatbuffer_t* fb, uint32_t vector, uint32_t index)
+{
+	return fb_deref(fb, vector + 4U * index);
+}
+
+/*
+ * Model loading
+ */
+
+static const char* operator_name(uint32_t code)
+{
+	switch (code)
+	{
+		case OP_AVERAGE_POOL_2D: return "AVERAGE_POOL_2D";
+		case OP_CONV_2D: return "CONV_2D";
+		case OP_FULLY_CONNECTED: return "FULLY_CONNECTED";
+		case OP_LOGISTIC: return "LOGISTIC";
+		case OP_MAX_POOL_2D: return "MAX_POOL_2D";
+		case OP_RELU: return "RELU";
+		case OP_RESHAPE: return "RESHAPE";
+		case OP_SOFTMAX: return "SOFTMAX";
+		case OP_TANH: return "TANH";
+		case OP_MEAN: return "MEAN";
+		case OP_UNIDIRECTIONAL_SEQUENCE_LSTM: return "UNIDIRECTIONAL_SEQUENCE_LSTM";
+		default: return "unsupported";
+	}
+}
+
+/**
+ * @brief Read the tensors of the subgraph (shape, type, constant data)
+ */
+static int32_t load_tensors(host_model_t* model, uint32_t subgraph, uint32_t buffers, uint32_t buffer_count)
+{
+	const flatbuffer_t* fb = &model->fb;
+
+	uint32_t count;
+	const uint32_t vector = fb_field_vector(fb, subgraph, 0, 4, &count);
+
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		host_tensor_t* tensor = &model->tensors[i];
+		const uint32_t table = fb_vector_table(fb, vector, i);
+		if (table == 0) return -1;
+
+		uint32_t dims;
+		const uint32_t shape = fb_field_vector(fb, table, 0, 4, &dims);
+		if (dims > MAX_DIMS) return -2;
+
+		tensor->dims = dims;
+		tensor->count = 1;
+		for (uint32_t d = 0; d < dims; ++d)
+		{
+			tensor->shape[d] = (int32_t)fb_u32(fb, shape + 4U * d);
+			if (tensor->shape[d] <= 0) return -3;
+			tensor->count *= (uint32_t)tensor->shape[d];
+		}
+
+		tensor->type = fb_field_u8(fb, table, 1, TYPE_FLOAT32);
+		tensor->variable = (fb_field_u8(fb, table, 5, 0) != 0);
+		tensor->first_use = -1;
+		tensor->last_use = -1;
+
+		// Constant data: buffer 0 is the empty buffer
+		const uint32_t buffer_index = fb_field_u32(fb, table, 2, 0);
+		if (buffer_index >= buffer_count) return -4;
+
+		uint32_t size = 0;
+		const uint32_t data = fb_field_vector(fb, fb_vector_table(fb, buffers, buffer_index), 0, 1, &size);
+		if ((size > 0) && !tensor->variable)
+		{
+			if (size != tensor->count * 4U) return -5;
+			if (((uintptr_t)(fb->data + data) % sizeof(float)) != 0) return -6;
+
+			tensor->data = (void*)(fb->data + data);
+			tensor->constant = true;
+		}
+
+		if ((tensor->type != TYPE_FLOAT32) && !((tensor->type == TYPE_INT32) && tensor->constant))
+		{
+			fprintf(stderr, "mtb_ml: tensor %lu: type %lu not supported (float32 models only)\n", (unsigned long)i, (unsigned long)tensor->type);
+			return -7;
+		}
+	}
+
+	return 0;
+}
+
+static bool tensor_is(const host_model_t* model, int32_t index, bool constant)
+{
+	return (index >= 0) && ((uint32_t)index < model->tensor_count) && (model->tensors[index].constant == constant);
+}
+
+/**
+ * @brief Padding before the first element for an output of out elements (TensorFlow Lite rule: the odd element goes after)
+ */
+static int32_t compute_padding(uint32_t padding, int32_t in, int32_t out, int32_t filter, int32_t stride, int32_t dilation, int32_t* pad)
+{
+	const int32_t effective = (filter - 1) * dilation + 1;
+	const int32_t expected = (padding == PADDING_SAME) ? ((in + stride - 1) / stride) : ((in - effective + stride) / stride);
+	if (expected != out) return -1;
+
+	const int32_t total = (out - 1) * stride + effective - in;
+	*pad = (total > 0) ? (total / 2) : 0;
+	return 0;
+}
+
+/**
+ * @brief Check the inputs and outputs of an operator, read its options
+ */
+static int32_t prepare_operator(host_model_t* model, host_operator_t* op, uint32_t options)
+{
+	const flatbuffer_t* fb = &model->fb;
+	host_tensor_t* tensors = model->tensors;
+
+	if (!tensor_is(model, op->output, false)) return -1;
+	if (!tensor_is(model, op->inputs[0], false) && (op->code != OP_RESHAPE)) return -1;
+
+	const host_tensor_t* input = (op->inputs[0] >= 0) ? &tensors[op->inputs[0]] : NULL;
+	const host_tensor_t* output = &tensors[op->output];
+	if ((input == NULL) || (input->type != TYPE_FLOAT32) || (output->type != TYPE_FLOAT32)) return -2;
+
+	switch (op->code)
+	{
+		case OP_RESHAPE:
+		case OP_LOGISTIC:
+		case OP_RELU:
+		case OP_TANH:
+			if (input->count != output->count) return -3;
+			break;
+
+		case OP_SOFTMAX:
+			op->beta = fb_field_f32(fb, options, 0, 0.0f);
+			if ((input->count != output->count) || (input->dims == 0)) return -3;
+			break;
+
+		case OP_CONV_2D:
+		case OP_AVERAGE_POOL_2D:
+		case OP_MAX_POOL_2D:
+		{
+			op->padding = fb_field_u8(fb, options, 0, PADDING_SAME);
+			op->stride_w = fb_field_i32(fb, options, 1, 0);
+			op->stride_h = fb_field_i32(fb, options, 2, 0);
+			op->dilation_w = 1;
+			op->dilation_h = 1;
+
+			if ((input->dims != 4) || (output->dims != 4) || (input->shape[0] != output->shape[0])) return -3;
+
+			if (op->code == OP_CONV_2D)
+			{
+				op->activation = fb_field_u8(fb, options, 3, ACTIVATION_NONE);
+				op->dilation_w = fb_field_i32(fb, options, 4, 1);
+				op->dilation_h = fb_field_i32(fb, options, 5, 1);
+
+				// Filter [out channels, height, width, in channels], bias [out channels]
+				if (!tensor_is(model, op->inputs[1], true)) return -4;
+				const host_tensor_t* filter = &tensors[op->inputs[1]];
+				if ((filter->dims != 4) || (filter->shape[0] != output->shape[3]) || (filter->shape[3] != input->shape[3])) return -4;
+				if ((op->input_count > 2) && (op->inputs[2] >= 0))
+				{
+					if (!tensor_is(model, op->inputs[2], true) || (tensors[op->inputs[2]].count != (uint32_t)output->shape[3])) return -4;
+				}
+				op->filter_h = filter->shape[1];
+				op->filter_w = filter->shape[2];
+			}
+			else
+			{
+				op->filter_w = fb_field_i32(fb, options, 3, 0);
+				op->filter_h = fb_field_i32(fb, options, 4, 0);
+				op->activation = fb_field_u8(fb, options, 5, ACTIVATION_NONE);
+				if (input->shape[3] != output->shape[3]) return -3;
+			}
+
+			if ((op->stride_w <= 0) || (op->stride_h <= 0) || (op->dilation_w <= 0) || (op->dilation_h <= 0)) return -5;
+			if ((op->filter_w <= 0) || (op->filter_h <= 0)) return -5;
+			if (compute_padding(op->padding, input->shape[1], output->shape[1], op->filter_h, op->stride_h, op->dilation_h, &op->pad_h) != 0) return -5;
+			if (compute_padding(op->padding, input->shape[2], output->shape[2], op->filter_w, op->stride_w, op->dilation_w, &op->pad_w) != 0) return -5;
+			break;
+		}
+
+		case OP_FULLY_CONNECTED:
+		{
+			op->activation = fb_field_u8(fb, options, 0, ACTIVATION_NONE);
+			if (fb_field_u8(fb, options, 1, 0) != 0) return -5;	// Shuffled weights
+
+			// Weights [units, depth], bias [units]
+			if (!tensor_is(model, op->inputs[1], true) || (tensors[op->inputs[1]].dims != 2)) return -4;
+			const host_tensor_t* weights = &tensors[op->inputs[1]];
+			const uint32_t units = (uint32_t)weights->shape[0];
+			const uint32_t depth = (uint32_t)weights->shape[1];
+			if ((input->count % depth) != 0) return -3;
+			if (output->count != (input->count / depth) * units) return -3;
+			if ((op->input_count > 2) && (op->inputs[2] >= 0))
+			{
+				if (!tensor_is(model, op->inputs[2], true) || (tensors[op->inputs[2]].count != units)) return -4;
+			}
+			break;
+		}
+
+		case OP_MEAN:
+		{
+			// Axes: constant int32
+			if (!tensor_is(model, op->inputs[1], true) || (tensors[op->inputs[1]].type != TYPE_INT32)) return -4;
+			const int32_t* axes = (const int32_t*)tensors[op->inputs[1]].data;
+			uint32_t reduced = 1;
+			for (uint32_t i = 0; i < tensors[op->inputs[1]].count; ++i)
+			{
+				const int32_t axis = (axes[i] < 0) ? (axes[i] + (int32_t)input->dims) : axes[i];
+				if ((axis < 0) || (axis >= (int32_t)input->dims)) return -4;
+				reduced *= (uint32_t)input->shape[axis];
+			}
+			if (output->count * reduced != input->count) return -3;
+			break;
+		}
+
+		case OP_UNIDIRECTIONAL_SEQUENCE_LSTM:
+		{
+			op->activation = fb_field_u8(fb, options, 0, ACTIVATION_TANH);
+			op->cell_clip = fb_field_f32(fb, options, 1, 0.0f);
+			op->time_major = (fb_field_u8(fb, options, 3, 0) != 0);
+
+			if ((op->input_count < 20) || (input->dims != 3) || (output->dims != 3)) return -3;
+
+			// Peephole, projection and layer normalization are not supported, CIFG (no input gate) is
+			for (uint32_t i = LSTM_CELL_TO_GATE; i < op->input_count; ++i)
+			{
+				if ((i >= LSTM_CELL_TO_GATE && i < LSTM_GATE_BIAS) || (i == LSTM_PROJECTION_WEIGHTS) || (i == LSTM_PROJECTION_BIAS) || (i >= LSTM_LAYER_NORM))
+				{
+					if (op->inputs[i] >= 0) return -5;
+				}
+			}
+
+			const uint32_t batches = (uint32_t)input->shape[op->time_major ? 1 : 0];
+			const uint32_t depth = (uint32_t)input->shape[2];
+			const uint32_t units = (uint32_t)output->shape[2];
+			if ((output->shape[0] != input->shape[0]) || (output->shape[1] != input->shape[1])) return -3;
+
+			const bool cifg = (op->inputs[LSTM_INPUT_TO_GATE] < 0);
+			for (uint32_t gate = cifg ? 1U : 0U; gate < 4U; ++gate)
+			{
+				if (!tensor_is(model, op->inputs[LSTM_INPUT_TO_GATE + gate], true) || (tensors[op->inputs[LSTM_INPUT_TO_GATE + gate]].count != units * depth)) return -4;
+				if (!tensor_is(model, op->inputs[LSTM_RECURRENT_TO_GATE + gate], true) || (tensors[op->inputs[LSTM_RECURRENT_TO_GATE + gate]].count != units * units)) return -4;
+				if (!tensor_is(model, op->inputs[LSTM_GATE_BIAS + gate], true) || (tensors[op->inputs[LSTM_GATE_BIAS + gate]].count != units)) return -4;
+			}
+
+			for (uint32_t i = LSTM_OUTPUT_STATE; i <= LSTM_CELL_STATE; ++i)
+			{
+				if (!tensor_is(model, op->inputs[i], false) || !tensors[op->inputs[i]].variable || (tensors[op->inputs[i]].count != batches * units)) return -4;
+			}
+
+			// Scratch: the 4 gates of one batch
+			op->scratch = (int32_t)model->tensor_count;
+			host_tensor_t* scratch = &model->tensors[model->tensor_count++];
+			scratch->count = 4U * units;
+			scratch->dims = 1;
+			scratch->shape[0] = (int32_t)scratch->count;
+			scratch->type = TYPE_FLOAT32;
+			scratch->first_use = -1;
+			scratch->last_use = -1;
+			break;
+		}
+
+		default:
+			return -6;
+	}
+
+	switch (op->activation)
+	{
+		case ACTIVATION_NONE:
+		case ACTIVATION_RELU:
+		case ACTIVATION_RELU_N1_TO_1:
+		case ACTIVATION_RELU6:
+		case ACTIVATION_TANH:
+			break;
+		default:
+			return -7;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Read the operators of the subgraph
+ */
+static int32_t load_operators(host_model_t* model, uint32_t subgraph, const uint32_t* codes, uint32_t code_count)
+{
+	const flatbuffer_t* fb = &model->fb;
+
+	// Scratch tensors are added after the tensors of the model by prepare_operator
+	const int32_t tensor_count = (int32_t)model->tensor_count;
+
+	uint32_t count;
+	const uint32_t vector = fb_field_vector(fb, subgraph, 3, 4, &count);
+
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		host_operator_t* op = &model->operators[i];
+		const uint32_t table = fb_vector_table(fb, vector, i);
+		if (table == 0) return -1;
+
+		const uint32_t code_index = fb_field_u32(fb, table, 0, 0);
+		if (code_index >= code_count) return -1;
+		op->code = codes[code_index];
+
+		uint32_t input_count, output_count;
+		const uint32_t inputs = fb_field_vector(fb, table, 1, 4, &input_count);
+		const uint32_t outputs = fb_field_vector(fb, table, 2, 4, &output_count);
+		if ((input_count == 0) || (input_count > MAX_OP_INPUTS) || (output_count != 1)) return -1;
+
+		op->input_count = input_count;
+		for (uint32_t j = 0; j < input_count; ++j)
+		{
+			op->inputs[j] = (int32_t)fb_u32(fb, inputs + 4U * j);
+			if ((op->inputs[j] < -1) || (op->inputs[j] >= tensor_count)) return -1;
+		}
+		for (uint32_t j = input_count; j < MAX_OP_INPUTS; ++j)
+		{
+			op->inputs[j] = -1;
+		}
+		op->output = (int32_t)fb_u32(fb, outputs);
+		op->scratch = -1;
+		if ((op->output < 0) || (op->output >= tensor_count)) return -1;
+
+		const int32_t result = prepare_operator(model, op, fb_field_table(fb, table, 4));
+		if (result != 0)
+		{
+			fprintf(stderr, "mtb_ml: operator %lu (%s, code %lu) not supported (%ld)\n", (unsigned long)i, operator_name(op->code), (unsigned long)op->code, (long)result);
+			return -2;
+		}
+	}
+
+	model->operator_count = count;
+	return 0;
+}
+
+/**
+ * @brief Lifetime of the tensors placed inside of the arena (in operators)
+ */
+static void compute_lifetimes(host_model_t* model)
+{
+	const int32_t end = (int32_t)model->operator_count;
+
+	for (int32_t i = 0; i < end; ++i)
+	{
+		host_operator_t* op = &model->operators[i];
+		for (uint32_t j = 0; j < op->input_count; ++j)
+		{
+			if (op->inputs[j] < 0) continue;
+			host_tensor_t* tensor = &model->tensors[op->inputs[j]];
+			if (tensor->first_use < 0) tensor->first_use = i;
+			tensor->last_use = i;
+		}
+
+		host_tensor_t* output = &model->tensors[op->output];
+		if (output->first_use < 0) output->first_use = i;
+		output->last_use = i;
+
+		if (op->scratch >= 0)
+		{
+			model->tensors[op->scratch].first_use = i;
+			model->tensors[op->scratch].last_use = i;
+		}
+	}
+
+	// Written before the first operator, read after the last one, or kept from one run to the next
+	model->tensors[model->input].first_use = 0;
+	if (model->tensors[model->input].last_use < 0) model->tensors[model->input].last_use = 0;
+	model->tensors[model->output].last_use = end;
+	if (model->tensors[model->output].first_use < 0) model->tensors[model->output].first_use = 0;
+
+	for (uint32_t i = 0; i < model->tensor_count; ++i)
+	{
+		host_tensor_t* tensor = &model->tensors[i];
+		if (tensor->variable)
+		{
+			tensor->first_use = 0;
+			tensor->last_use = end;
+		}
+	}
+}
+
+static uint32_t tensor_bytes(const host_tensor_t* tensor)
+{
+	return (tensor->count * 4U + ARENA_ALIGNMENT - 1U) & ~(ARENA_ALIGNMENT - 1U);
+}
+
+/**
+ * @brief Place the tensors inside of the arena: biggest first, at the lowest offset not used by a tensor alive at the same time
+ *
+ * @retval Bytes of the arena needed
+ */
+static uint32_t plan_arena(host_model_t* model)
+{
+	const uint32_t count = model->tensor_count;
+	bool* placed = calloc(count, sizeof(bool));
+	uint32_t arena_used = 0;
+
+	if (placed == NULL) return UINT32_MAX;
+
+	for (;;)
+	{
+		// Biggest tensor not placed yet
+		int32_t next = -1;
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const host_tensor_t* tensor = &model->tensors[i];
+			if (placed[i] || tensor->constant || (tensor->first_use < 0)) continue;
+			if ((next < 0) || (tensor->count > model->tensors[next].count)) next = (int32_t)i;
+		}
+		if (next < 0) break;
+
+		host_tensor_t* tensor = &model->tensors[next];
+		const uint32_t size = tensor_bytes(tensor);
+
+		// Lowest offset: try 0 then the end of every placed tensor alive at the same time
+		uint32_t best = UINT32_MAX;
+		for (int32_t candidate = -1; candidate < (int32_t)count; ++candidate)
+		{
+			uint32_t offset = 0;
+			if (candidate >= 0)
+			{
+				const host_tensor_t* other = &model->tensors[candidate];
+				if (!placed[candidate] || (other->last_use < tensor->first_use) || (other->first_use > tensor->last_use)) continue;
+				offset = other->arena_offset + tensor_bytes(other);
+			}
+			if (offset >= best) continue;
+
+			bool overlap = false;
+			for (uint32_t i = 0; (i < count) && !overlap; ++i)
+			{
+				const host_tensor_t* other = &model->tensors[i];
+				if (!placed[i] || (other->last_use < tensor->first_use) || (other->first_use > tensor->last_use)) continue;
+				overlap = (offset < other->arena_offset + tensor_bytes(other)) && (other->arena_offset < offset + size);
+			}
+			if (!overlap) best = offset;
+		}
+
+		tensor->arena_offset = best;
+		placed[next] = true;
+		if (best + size > arena_used) arena_used = best + size;
+	}
+
+	free(placed);
+	return arena_used;
+}
+
+cy_rslt_t mtb_ml_model_init(const mtb_ml_model_bin_t* bin, const mtb_ml_model_buffer_t* buffer, mtb_ml_model_t** object)
+{
+	if ((bin == NULL) || (buffer == NULL) || (object == NULL)) return MTB_ML_RESULT_BAD_ARG;
+	if ((bin->model_bin == NULL) || (bin->model_size < 8) || (buffer->tensor_arena == NULL)) return MTB_ML_RESULT_BAD_ARG;
+	if (((uintptr_t)buffer->tensor_arena % ARENA_ALIGNMENT) != 0) return MTB_ML_RESULT_BAD_ARG;
+
+	const flatbuffer_t fb = { .data = bin->model_bin, .size = (uint32_t)bin->model_size };
+
+	// Model: version 3, one subgraph
+	const uint32_t root = fb_deref(&fb, 0);
+	if ((root == 0) || (fb_field_u32(&fb, root, 0, 0) != 3U))
+	{
+		fprintf(stderr, "mtb_ml: not a TensorFlow Lite model (schema version 3)\n");
+		return MTB_ML_RESULT_BAD_MODEL;
+	}
+
+	uint32_t code_count, subgraph_count, buffer_count;
+	const uint32_t code_vector = fb_field_vector(&fb, root, 1, 4, &code_count);
+	const uint32_t subgraph_vector = fb_field_vector(&fb, root, 2, 4, &subgraph_count);
+	const uint32_t buffers = fb_field_vector(&fb, root, 4, 4, &buffer_count);
+	if (subgraph_count != 1) return MTB_ML_RESULT_BAD_MODEL;
+
+	const uint32_t subgraph = fb_vector_table(&fb, subgraph_vector, 0);
+
+	uint32_t tensor_count, operator_count, input_count, output_count;
+	fb_field_vector(&fb, subgraph, 0, 4, &tensor_count);
+	fb_field_vector(&fb, subgraph, 3, 4, &operator_count);
+	const uint32_t inputs = fb_field_vector(&fb, subgraph, 1, 4, &input_count);
+	const uint32_t outputs = fb_field_vector(&fb, subgraph, 2, 4, &output_count);
+	if ((tensor_count == 0) || (operator_count == 0) || (input_count != 1) || (output_count != 1)) return MTB_ML_RESULT_BAD_MODEL;
+
+	// Builtin code: the biggest of the deprecated (int8) and of the new (int32) fields
+	uint32_t* codes = calloc(code_count + 1U, sizeof(uint32_t));
+	if (codes == NULL) return MTB_ML_RESULT_ALLOC_ERR;
+	for (uint32_t i = 0; i < code_count; ++i)
+	{
+		const uint32_t table = fb_vector_table(&fb, code_vector, i);
+		const uint32_t deprecated_code = fb_field_u8(&fb, table, 0, 0);
+		const uint32_t code = (uint32_t)fb_field_i32(&fb, table, 3, 0);
+		codes[i] = (code > deprecated_code) ? code : deprecated_code;
+	}
+
+	// Scratch tensors are added after the tensors of the model, at most one per operator
+	host_model_t* model = calloc(1, sizeof(host_model_t));
+	if (model != NULL)
+	{
+		model->tensors = calloc(tensor_count + operator_count, sizeof(host_tensor_t));
+		model->operators = calloc(operator_count, sizeof(host_operator_t));
+	}
+	if ((model == NULL) || (model->tensors == NULL) || (model->operators == NULL))
+	{
+		free(codes);
+		mtb_ml_model_deinit((mtb_ml_model_t*)model);
+		return MTB_ML_RESULT_ALLOC_ERR;
+	}
+
+	model->fb = fb;
+	model->tensor_count = tensor_count;
+	model->input = (int32_t)fb_u32(&fb, inputs);
+	model->output = (int32_t)fb_u32(&fb, outputs);
+
+	cy_rslt_t result = MTB_ML_RESULT_SUCCESS;
+	if ((model->input < 0) || (model->input >= (int32_t)tensor_count) || (model->output < 0) || (model->output >= (int32_t)tensor_count))
+	{
+		result = MTB_ML_RESULT_BAD_MODEL;
+	}
+	else if ((load_tensors(model, subgraph, buffers, buffer_count) != 0) || (load_operators(model, subgraph, codes, code_count) != 0))
+	{
+		result = MTB_ML_RESULT_BAD_MODEL;
+	}
+	else if ((model->tensors[model->input].type != TYPE_FLOAT32) || (model->tensors[model->output].type != TYPE_FLOAT32))
+	{
+		result = MTB_ML_RESULT_MISMATCH_DATA_TYPE;
+	}
+	else if (model->tensors[model->input].constant || model->tensors[model->input].variable || model->tensors[model->output].constant)
+	{
+		result = MTB_ML_RESULT_BAD_MODEL;
+	}
+	free(codes);
+
+	if (result == MTB_ML_RESULT_SUCCESS)
+	{
+		compute_lifetimes(model);
+		const uint32_t arena_used = plan_arena(model);
+		if ((arena_used == UINT32_MAX) || (arena_used > (uint32_t)buffer->tensor_arena_size))
+		{
+			fprintf(stderr, "mtb_ml: tensor arena too small (%lu bytes needed, %ld given)\n", (unsigned long)arena_used, (long)buffer->tensor_arena_size);
+			result = MTB_ML_RESULT_ALLOC_ERR;
+		}
+		else
+		{
+			model->arena = buffer->tensor_arena;
+			model->arena_size = (uint32_t)buffer->tensor_arena_size;
+			for (uint32_t i = 0; i < model->tensor_count; ++i)
+			{
+				host_tensor_t* tensor = &model->tensors[i];
+				if (!tensor->constant && (tensor->first_use >= 0)) tensor->data = model->arena + tensor->arena_offset;
+			}
+			model->object.buffer_size = (int)arena_used;
+		}
+	}
+
+	if (result != MTB_ML_RESULT_SUCCESS)
+	{
+		mtb_ml_model_deinit((mtb_ml_model_t*)model);
+		return result;
+	}
+
+	strncpy(model->object.name, bin->name, MTB_ML_MODEL_NAME_LEN - 1);
+	model->object.name[MTB_ML_MODEL_NAME_LEN - 1] = '\0';
+	model->object.model_size = bin->model_size;
+	model->object.input_size = (int)model->tensors[model->input].count;
+	model->object.output_size = (int)model->tensors[model->output].count;
+	model->object.output = (MTB_ML_DATA_T*)model->tensors[model->output].data;
+
+	// Variable tensors start from zero (TensorFlow Lite Micro: reset when the tensors are allocated)
+	mtb_ml_model_rnn_reset_all_parameters(&model->object);
+
+	*object = &model->object;
+	return MTB_ML_RESULT_SUCCESS;
+}
+
+cy_rslt_t mtb_ml_model_deinit(mtb_ml_model_t* object)
+{
+	host_model_t* model = (host_model_t*)object;
+	if (model == NULL) return MTB_ML_RESULT_BAD_ARG;
+
+	free(model->tensors);
+	free(model->operators);
+	free(model);
+	return MTB_ML_RESULT_SUCCESS;
+}
+
+cy_rslt_t mtb_ml_model_rnn_reset_all_parameters(mtb_ml_model_t* object)
+{
+	host_model_t* model = (host_model_t*)object;
+	if (model == NULL) return MTB_ML_RESULT_BAD_ARG;
+
+	for (uint32_t i = 0; i < model->tensor_count; ++i)
+	{
+		if (model->tensors[i].variable) memset(model->tensors[i].data, 0, model->tensors[i].count * sizeof(float));
+	}
+	return MTB_ML_RESULT_SUCCESS;
+}
+
+/*
+ * Operators
+ */
+
+static inline float activate(uint32_t activation, float value)
+{
+	switch (activation)
+	{
+		case ACTIVATION_RELU: return (value > 0.0f) ? value : 0.0f;
+		case ACTIVATION_RELU_N1_TO_1: return (value > 1.0f) ? 1.0f : ((value < -1.0f) ? -1.0f : value);
+		case ACTIVATION_RELU6: return (value > 6.0f) ? 6.0f : ((value < 0.0f) ? 0.0f : value);
+		case ACTIVATION_TANH: return tanhf(value);
+		default: return value;
+	}
+}
+
+static inline float sigmoid(float value)
+{
+	return 1.0f / (1.0f + expf(-value));
+}
+
+static inline float dot(const float* a, const float* b, uint32_t count)
+{
+	float sum = 0.0f;
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		sum += a[i] * b[i];
+	}
+	return sum;
+}
+
+static void run_conv_2d(const host_model_t* model, const host_operator_t* op)
+{
+	const host_tensor_t* input = &model->tensors[op->inputs[0]];
+	const host_tensor_t* output = &model->tensors[op->output];
+	const float* in = (const float*)input->data;
+	const float* filter = (const float*)model->tensors[op->inputs[1]].data;
+	const float* bias = ((op->input_count > 2) && (op->inputs[2] >= 0)) ? (const float*)model->tensors[op->inputs[2]].data : NULL;
+	float* out = (float*)output->data;
+
+	const int32_t in_h = input->shape[1], in_w = input->shape[2], in_c = input->shape[3];
+	const int32_t out_h = output->shape[1], out_w = output->shape[2], out_c = output->shape[3];
+
+	for (int32_t b = 0; b < input->shape[0]; ++b)
+	{
+		for (int32_t y = 0; y < out_h; ++y)
+		{
+			for (int32_t x = 0; x < out_w; ++x)
+			{
+				float* dst = &out[((b * out_h + y) * out_w + x) * out_c];
+				for (int32_t c = 0; c < out_c; ++c)
+				{
+					dst[c] = (bias != NULL) ? bias[c] : 0.0f;
+				}
+
+				for (int32_t ky = 0; ky < op->filter_h; ++ky)
+				{
+					const int32_t in_y = y * op->stride_h - op->pad_h + ky * op->dilation_h;
+					if ((in_y < 0) || (in_y >= in_h)) continue;
+
+					for (int32_t kx = 0; kx < op->filter_w; ++kx)
+					{
+						const int32_t in_x = x * op->stride_w - op->pad_w + kx * op->dilation_w;
+						if ((in_x < 0) || (in_x >= in_w)) continue;
+
+						const float* src = &in[((b * in_h + in_y) * in_w + in_x) * in_c];
+						const float* weights = &filter[(ky * op->filter_w + kx) * in_c];
+						const int32_t filter_stride = op->filter_h * op->filter_w * in_c;
+						for (int32_t c = 0; c < out_c; ++c)
+						{
+							dst[c] += dot(src, &weights[c * filter_stride], (uint32_t)in_c);
+						}
+					}
+				}
+
+				for (int32_t c = 0; c < out_c; ++c)
+				{
+					dst[c] = activate(op->activation, dst[c]);
+				}
+			}
+		}
+	}
+}
+
+static void run_pool_2d(const host_model_t* model, const host_operator_t* op)
+{
+	const host_tensor_t* input = &model->tensors[op->inputs[0]];
+	const host_tensor_t* output = &model->tensors[op->output];
+	const float* in = (const float*)input->data;
+	float* out = (float*)output->data;
+
+	const int32_t in_h = input->shape[1], in_w = input->shape[2], channels = input->shape[3];
+	const int32_t out_h = output->shape[1], out_w = output->shape[2];
+
+	for (int32_t b = 0; b < input->shape[0]; ++b)
+	{
+		for (int32_t y = 0; y < out_h; ++y)
+		{
+			for (int32_t x = 0; x < out_w; ++x)
+			{
+				for (int32_t c = 0; c < channels; ++c)
+				{
+					// Padded elements are ignored (not counted in the average)
+					float value = (op->code == OP_MAX_POOL_2D) ? -INFINITY : 0.0f;
+					uint32_t count = 0;
+
+					for (int32_t ky = 0; ky < op->filter_h; ++ky)
+					{
+						const int32_t in_y = y * op->stride_h - op->pad_h + ky;
+						if ((in_y < 0) || (in_y >= in_h)) continue;
+
+						for (int32_t kx = 0; kx < op->filter_w; ++kx)
+						{
+							const int32_t in_x = x * op->stride_w - op->pad_w + kx;
+							if ((in_x < 0) || (in_x >= in_w)) continue;
+
+							const float element = in[((b * in_h + in_y) * in_w + in_x) * channels + c];
+							if (op->code == OP_MAX_POOL_2D)
+							{
+								value = (element > value) ? element : value;
+							}
+							else
+							{
+								value += element;
+							}
+							count++;
+						}
+					}
+
+					if ((op->code == OP_AVERAGE_POOL_2D) && (count > 0)) value /= (float)count;
+					out[((b * out_h + y) * out_w + x) * channels + c] = activate(op->activation, value);
+				}
+			}
+		}
+	}
+}
+
+static void run_fully_connected(const host_model_t* model, const host_operator_t* op)
+{
+	const host_tensor_t* input = &model->tensors[op->inputs[0]];
+	const host_tensor_t* weights = &model->tensors[op->inputs[1]];
+	const float* in = (const float*)input->data;
+	const float* w = (const float*)weights->data;
+	const float* bias = ((op->input_count > 2) && (op->inputs[2] >= 0)) ? (const float*)model->tensors[op->inputs[2]].data : NULL;
+	float* out = (float*)model->tensors[op->output].data;
+
+	const uint32_t units = (uint32_t)weights->shape[0];
+	const uint32_t depth = (uint32_t)weights->shape[1];
+	const uint32_t batches = input->count / depth;
+
+	for (uint32_t b = 0; b < batches; ++b)
+	{
+		for (uint32_t u = 0; u < units; ++u)
+		{
+			const float sum = ((bias != NULL) ? bias[u] : 0.0f) + dot(&in[b * depth], &w[u * depth], depth);
+			out[b * units + u] = activate(op->activation, sum);
+		}
+	}
+}
+
+static void run_mean(const host_model_t* model, const host_operator_t* op)
+{
+	const host_tensor_t* input = &model->tensors[op->inputs[0]];
+	const host_tensor_t* axes_tensor = &model->tensors[op->inputs[1]];
+	const host_tensor_t* output = &model->tensors[op->output];
+	const float* in = (const float*)input->data;
+	const int32_t* axes = (const int32_t*)axes_tensor->data;
+	float* out = (float*)output->data;
+
+	bool reduce[MAX_DIMS] = { false };
+	for (uint32_t i = 0; i < axes_tensor->count; ++i)
+	{
+		reduce[(axes[i] < 0) ? (axes[i] + (int32_t)input->dims) : axes[i]] = true;
+	}
+
+	memset(out, 0, output->count * sizeof(float));
+
+	// Walk the input, index of the output = index of the input without the reduced dimensions
+	uint32_t index[MAX_DIMS] = { 0 };
+	for (uint32_t i = 0; i < input->count; ++i)
+	{
+		uint32_t out_index = 0;
+		for (uint32_t d = 0; d < input->dims; ++d)
+		{
+			if (!reduce[d]) out_index = out_index * (uint32_t)input->shape[d] + index[d];
+		}
+		out[out_index] += in[i];
+
+		for (int32_t d = (int32_t)input->dims - 1; d >= 0; --d)
+		{
+			if (++index[d] < (uint32_t)input->shape[d]) break;
+			index[d] = 0;
+		}
+	}
+
+	const float scale = (float)output->count / (float)input->count;
+	for (uint32_t i = 0; i < output->count; ++i)
+	{
+		out[i] *= scale;
+	}
+}
+
+static void run_softmax(const host_model_t* model, const host_operator_t* op)
+{
+	const host_tensor_t* input = &model->tensors[op->inputs[0]];
+	const float* in = (const float*)input->data;
+	float* out = (float*)model->tensors[op->output].data;
+
+	const uint32_t depth = (uint32_t)input->shape[input->dims - 1];
+
+	for (uint32_t offset = 0; offset < input->count; offset += depth)
+	{
+		float max = in[offset];
+		for (uint32_t i = 1; i < depth; ++i)
+		{
+			max = (in[offset + i] > max) ? in[offset + i] : max;
+		}
+
+		float sum = 0.0f;
+		for (uint32_t i = 0; i < depth; ++i)
+		{
+			out[offset + i] = expf((in[offset + i] - max) * op->beta);
+			sum += out[offset + i];
+		}
+
+		for (uint32_t i = 0; i < depth; ++i)
+		{
+			out[offset + i] /= sum;
+		}
+	}
+}
+
+static void run_elementwise(const host_model_t* model, const host_operator_t* op)
+{
+	const host_tensor_t* input = &model->tensors[op->inputs[0]];
+	const float* in = (const float*)input->data;
+	float* out = (float*)model->tensors[op->output].data;
+
+	for (uint32_t i = 0; i < input->count; ++i)
+	{
+		switch (op->code)
+		{
+			case OP_LOGISTIC: out[i] = sigmoid(in[i]); break;
+			case OP_RELU: out[i] = (in[i] > 0.0f) ? in[i] : 0.0f; break;
+			case OP_TANH: out[i] = tanhf(in[i]); break;
+			default: out[i] = in[i]; break;
+		}
+	}
+}
+
+/**
+ * @brief LSTM over the time steps of the input, the hidden and cell states (variable tensors) are kept for the next run
+ *
+ * gates = W x + R h + b, c = sigmoid(f) * c + sigmoid(i) * act(g), h = sigmoid(o) * act(c)
+ * CIFG (no input gate): i = 1 - sigmoid(f)
+ */
+static void run_lstm(const host_model_t* model, const host_operator_t* op)
+{
+	const host_tensor_t* input = &model->tensors[op->inputs[LSTM_INPUT]];
+	const host_tensor_t* output = &model->tensors[op->output];
+	const float* in = (const float*)input->data;
+	float* out = (float*)output->data;
+	float* hidden_state = (float*)model->tensors[op->inputs[LSTM_OUTPUT_STATE]].data;
+	float* cell_state = (float*)model->tensors[op->inputs[LSTM_CELL_STATE]].data;
+	float* gates = (float*)model->tensors[op->scratch].data;
+
+	const bool cifg = (op->inputs[LSTM_INPUT_TO_GATE] < 0);
+	const uint32_t batches = (uint32_t)input->shape[op->time_major ? 1 : 0];
+	const uint32_t steps = (uint32_t)input->shape[op->time_major ? 0 : 1];
+	const uint32_t depth = (uint32_t)input->shape[2];
+	const uint32_t units = (uint32_t)output->shape[2];
+
+	for (uint32_t b = 0; b < batches; ++b)
+	{
+		float* h = &hidden_state[b * units];
+		float* c = &cell_state[b * units];
+
+		for (uint32_t t = 0; t < steps; ++t)
+		{
+			const uint32_t row = op->time_major ? (t * batches + b) : (b * steps + t);
+			const float* x = &in[row * depth];
+
+			for (uint32_t gate = cifg ? 1U : 0U; gate < 4U; ++gate)
+			{
+				const float* w = (const float*)model->tensors[op->inputs[LSTM_INPUT_TO_GATE + gate]].data;
+				const float* r = (const float*)model->tensors[op->inputs[LSTM_RECURRENT_TO_GATE + gate]].data;
+				const float* bias = (const float*)model->tensors[op->inputs[LSTM_GATE_BIAS + gate]].data;
+
+				for (uint32_t u = 0; u < units; ++u)
+				{
+					gates[gate * units + u] = bias[u] + dot(x, &w[u * depth], depth) + dot(h, &r[u * units], units);
+				}
+			}
+
+			for (uint32_t u = 0; u < units; ++u)
+			{
+				const float forget_gate = sigmoid(gates[units + u]);
+				const float input_gate = cifg ? (1.0f - forget_gate) : sigmoid(gates[u]);
+				const float cell_gate = activate(op->activation, gates[2U * units + u]);
+				gates[3U * units + u] = sigmoid(gates[3U * units + u]);
+
+				float cell = forget_gate * c[u] + input_gate * cell_gate;
+				if (op->cell_clip > 0.0f)
+				{
+					cell = (cell > op->cell_clip) ? op->cell_clip : ((cell < -op->cell_clip) ? -op->cell_clip : cell);
+				}
+				c[u] = cell;
+			}
+
+			// h is only updated once all the gates of the step are computed
+			for (uint32_t u = 0; u < units; ++u)
+			{
+				h[u] = gates[3U * units + u] * activate(op->activation, c[u]);
+			}
+			memcpy(&out[row * units], h, units * sizeof(float));
+		}
+	}
+}
+
+static void run_operator(const host_model_t* model, const host_operator_t* op)
+{
+	switch (op->code)
+	{
+		case OP_CONV_2D:
+			run_conv_2d(model, op);
+			break;
+		case OP_AVERAGE_POOL_2D:
+		case OP_MAX_POOL_2D:
+			run_pool_2d(model, op);
+			break;
+		case OP_FULLY_CONNECTED:
+			run_fully_connected(model, op);
+			break;
+		case OP_MEAN:
+			run_mean(model, op);
+			break;
+		case OP_SOFTMAX:
+			run_softmax(model, op);
+			break;
+		case OP_UNIDIRECTIONAL_SEQUENCE_LSTM:
+			run_lstm(model, op);
+			break;
+		case OP_RESHAPE:
+			memmove(model->tensors[op->output].data, model->tensors[op->inputs[0]].data, model->tensors[op->output].count * sizeof(float));
+			break;
+		default:
+			run_elementwise(model, op);
+			break;
+	}
+}
+
+static uint64_t time_ns(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+cy_rslt_t mtb_ml_model_run(mtb_ml_model_t* object, MTB_ML_DATA_T* input)
+{
+	host_model_t* model = (host_model_t*)object;
+	if ((model == NULL) || (input == NULL)) return MTB_ML_RESULT_BAD_ARG;
+
+	const bool profile_layers = ((object->profiling & (MTB_ML_PROFILE_ENABLE_LAYER | MTB_ML_PROFILE_ENABLE_LAYER_PER_FRAME)) != 0);
+	const uint64_t start = time_ns();
+
+	memcpy(model->tensors[model->input].data, input, (size_t)object->input_size * sizeof(float));
+
+	for (uint32_t i = 0; i < model->operator_count; ++i)
+	{
+		host_operator_t* op = &model->operators[i];
+		const uint64_t op_start = profile_layers ? time_ns() : 0;
+
+		run_operator(model, op);
+
+		if (profile_layers)
+		{
+			op->profile_last = time_ns() - op_start;
+			op->profile_time += op->profile_last;
+		}
+	}
+
+	object->m_time = time_ns() - start;
+
+	if (object->profiling != MTB_ML_PROFILE_DISABLE)
+	{
+		object->m_sum_frames++;
+		object->m_sum_time += object->m_time;
+		if (object->m_time > object->m_peak_time)
+		{
+			object->m_peak_time = object->m_time;
+			object->m_peak_frame = object->m_sum_frames;
+		}
+	}
+
+	if ((object->profiling & MTB_ML_PROFILE_ENABLE_MODEL_PER_FRAME) != 0)
+	{
+		printf("%s: frame %lu: %.3f us\r\n", object->name, (unsigned long)object->m_sum_frames, (double)object->m_time / 1000.0);
+	}
+	if ((object->profiling & MTB_ML_PROFILE_ENABLE_LAYER_PER_FRAME) != 0)
+	{
+		for (uint32_t i = 0; i < model->operator_count; ++i)
+		{
+			printf("%s: frame %lu: layer %lu %s: %.3f us\r\n", object->name, (unsigned long)object->m_sum_frames, (unsigned long)i,
+					operator_name(model->operators[i].code), (double)model->operators[i].profile_last / 1000.0);
+		}
+	}
+	if ((object->profiling & MTB_ML_LOG_ENABLE_MODEL_LOG) != 0)
+	{
+		printf("%s: frame %lu: output", object->name, (unsigned long)object->m_sum_frames);
+		for (int i = 0; i < object->output_size; ++i)
+		{
+			printf(" %f", (double)object->output[i]);
+		}
+		printf("\r\n");
+	}
+
+	return MTB_ML_RESULT_SUCCESS;
+}
+
+cy_rslt_t mtb_ml_model_profile_config(mtb_ml_model_t* object, mtb_ml_profile_config_t config)
+{
+	host_model_t* model = (host_model_t*)object;
+	if (model == NULL) return MTB_ML_RESULT_BAD_ARG;
+
+	object->profiling = config;
+	object->m_sum_frames = 0;
+	object->m_sum_time = 0;
+	object->m_peak_frame = 0;
+	object->m_peak_time = 0;
+	for (uint32_t i = 0; i < model->operator_count; ++i)
+	{
+		model->operators[i].profile_time = 0;
+	}
+
+	return MTB_ML_RESULT_SUCCESS;
+}
+
+cy_rslt_t mtb_ml_model_profile_log(mtb_ml_model_t* object)
+{
+	host_model_t* model = (host_model_t*)object;
+	if (model == NULL) return MTB_ML_RESULT_BAD_ARG;
+	if (object->m_sum_frames == 0) return MTB_ML_RESULT_SUCCESS;
+
+	const double frames = (double)object->m_sum_frames;
+	printf("%s: %lu frames, average %.3f us, peak %.3f us (frame %lu), %.0f frames/s\r\n", object->name, (unsigned long)object->m_sum_frames,
+			(double)object->m_sum_time / frames / 1000.0, (double)object->m_peak_time / 1000.0, (unsigned long)object->m_peak_frame,
+			(object->m_sum_time > 0) ? (frames * 1e9 / (double)object->m_sum_time) : 0.0);
+
+	if ((object->profiling & MTB_ML_PROFILE_ENABLE_LAYER) != 0)
+	{
+		for (uint32_t i = 0; i < model->operator_count; ++i)
+		{
+			const host_operator_t* op = &model->operators[i];
+			printf("  layer %2lu %-28s average %.3f us (%.1f %%)\r\n", (unsigned long)i, operator_name(op->code), (double)op->profile_time / frames / 1000.0,
+					(object->m_sum_time > 0) ? (100.0 * (double)op->profile_time / (double)object->m_sum_time) : 0.0);
+		}
+	}
+
+	return MTB_ML_RESULT_SUCCESS;
+}
+
+void mtb_ml_utils_print_model_info(const mtb_ml_model_t* object)
+{
+	const host_model_t* model = (const host_model_t*)object;
+	if (model == NULL) return;
+
+	printf("Model: %s\r\n", object->name);
+	printf("  model size: %d bytes\r\n", object->model_size);
+	printf("  tensor arena: %d bytes used of %lu\r\n", object->buffer_size, (unsigned long)model->arena_size);
+	printf("  input: %d floats, output: %d floats\r\n", object->input_size, object->output_size);
+	for (uint32_t i = 0; i < model->operator_count; ++i)
+	{
+		const host_tensor_t* output = &model->tensors[model->operators[i].output];
+		printf("  layer %2lu %-28s output", (unsigned long)i, operator_name(model->operators[i].code));
+		for (uint32_t d = 0; d < output->dims; ++d)
+		{
+			printf("%s%ld", (d == 0) ? " [" : ", ", (long)output->shape[d]);
+		}
+		printf("]\r\n");
+	}
+}
+
+cy_rslt_t mtb_ml_init(int npu_priority)
+{
+	(void)npu_priority;
+	return MTB_ML_RESULT_SUCCESS;
+}
+
+cy_rslt_t mtb_ml_deinit(void)
+{
+	return MTB_ML_RESULT_SUCCESS;
+}
@@ -0,0 +1,113 @@
+/*
+ * mtb_ml_model.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ * Host (x86 / Linux) replacement of the ModusToolbox ml-middleware: model API (see mtb_ml.h)
+ *
+ * Rutronik Elektronische Bauelemente GmbH Disclaimer: The evaluation board
+ * including the software is for testing purposes only and,
+ * because it has limited functions and limited resilience, is not suitable
+ * for permanent use under real conditions. If the evaluation board is
+ * nevertheless used under real conditions, this is done at one’s responsibility;
+ * any liability of Rutronik is insofar excluded
+ */
+
+#ifndef HOST_MTB_ML_MODEL_H_
+#define HOST_MTB_ML_MODEL_H_
+
+#include "mtb_ml_common.h"
+
+/**
+ * Profiling options (flags)
+ */
+typedef enum
+{
+	MTB_ML_PROFILE_DISABLE = 0,
+	MTB_ML_PROFILE_ENABLE_MODEL = 1,			/**< Time of the runs, reported by mtb_ml_model_profile_log */
+	MTB_ML_PROFILE_ENABLE_LAYER = 2,			/**< Time of each operator, reported by mtb_ml_model_profile_log */
+	MTB_ML_PROFILE_ENABLE_MODEL_PER_FRAME = 4,	/**< Time of each run, printed by mtb_ml_model_run */
+	MTB_ML_PROFILE_ENABLE_LAYER_PER_FRAME = 8,	/**< Time of each operator, printed by mtb_ml_model_run */
+	MTB_ML_LOG_ENABLE_MODEL_LOG = 16			/**< Outputs of each run, printed by mtb_ml_model_run */
+} mtb_ml_profile_config_t;
+
+/**
+ * Model binary (flatbuffer of the TensorFlow Lite converter)
+ */
+typedef struct
+{
+	char name[MTB_ML_MODEL_NAME_LEN];
+	uint8_t* model_bin;
+	int model_size;
+	int arena_size;
+} mtb_ml_model_bin_t;
+
+/**
+ * Memory of the tensors (activations, variables and scratch buffers)
+ */
+typedef struct
+{
+	uint8_t* tensor_arena;
+	int tensor_arena_size;
+} mtb_ml_model_buffer_t;
+
+/**
+ * Model object. The time is measured in nanoseconds (target: CPU cycles).
+ */
+typedef struct
+{
+	char name[MTB_ML_MODEL_NAME_LEN];
+	int model_size;
+	int buffer_size;				/**< Bytes of the tensor arena used */
+	int lib_error;
+	MTB_ML_DATA_T* output;			/**< Output tensor, valid after mtb_ml_model_run */
+	int output_size;				/**< Elements of the output tensor */
+	int input_size;					/**< Elements of the input tensor */
+
+	mtb_ml_profile_config_t profiling;
+	uint64_t m_time;				/**< Last run */
+	uint32_t m_sum_frames;			/**< Runs since the profiling was configured */
+	uint64_t m_sum_time;
+	uint32_t m_peak_frame;
+	uint64_t m_peak_time;
+} mtb_ml_model_t;
+
+/**
+ * @brief Load a model (parse the flatbuffer, check the operators, plan the tensors inside of the arena)
+ *
+ * @param [in] bin	Model binary
+ * @param [in] buffer	Tensor arena (the arena stays owned by the caller, it has to live as long as the model)
+ * @param [out] object	Model object
+ *
+ * @retval MTB_ML_RESULT_SUCCESS	Success
+ * @retval MTB_ML_RESULT_BAD_MODEL	Invalid binary, or operator / data type not supported by the host interpreter
+ * @retval MTB_ML_RESULT_ALLOC_ERR	Arena too small
+ */
+cy_rslt_t mtb_ml_model_init(const mtb_ml_model_bin_t* bin, const mtb_ml_model_buffer_t* buffer, mtb_ml_model_t** object);
+
+/**
+ * @brief Free a model object
+ */
+cy_rslt_t mtb_ml_model_deinit(mtb_ml_model_t* object);
+
+/**
+ * @brief Run the model: copy input_size elements from input, the result is in object->output
+ */
+cy_rslt_t mtb_ml_model_run(mtb_ml_model_t* object, MTB_ML_DATA_T* input);
+
+/**
+ * @brief Clear the state of the recurrent layers (variable tensors), kept from one run to the next otherwise
+ */
+cy_rslt_t mtb_ml_model_rnn_reset_all_parameters(mtb_ml_model_t* object);
+
+/**
+ * @brief Enable the profiling (resets the measurements)
+ */
+cy_rslt_t mtb_ml_model_profile_config(mtb_ml_model_t* object, mtb_ml_profile_config_t config);
+
+/**
+ * @brief Print the measurements of the enabled profiling
+ */
+cy_rslt_t mtb_ml_model_profile_log(mtb_ml_model_t* object);
+
+#endif /* HOST_MTB_ML_MODEL_H_ */
@@ -0,0 +1,26 @@
+/*
+ * mtb_ml_utils.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ * Host (x86 / Linux) replacement of the ModusToolbox ml-middleware: utilities (see mtb_ml.h)
+ *
+ * Rutronik Elektronische Bauelemente GmbH Disclaimer: The evaluation board
+ * including the software is for testing purposes only and,
+ * because it has limited functions and limited resilience, is not suitable
+ * for permanent use under real conditions. If the evaluation board is
+ * nevertheless used under real conditions, this is done at one’s responsibility;
+ * any liability of Rutronik is insofar excluded
+ */
+
+#ifndef HOST_MTB_ML_UTILS_H_
+#define HOST_MTB_ML_UTILS_H_
+
+#include "mtb_ml_model.h"
+
+/**
+ * @brief Print the name, sizes and operators of a model
+ */
+void mtb_ml_utils_print_model_info(const mtb_ml_model_t* object);
+
+#endif /* HOST_MTB_ML_UTILS_H_ */
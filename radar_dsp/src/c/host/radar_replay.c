@@ -0,0 +1,431 @@
+/*
+ * radar_replay.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ * Host (x86 / Linux) replay of a radar recording (radar.npy of the Infineon Radar Fusion GUI, uint16 samples,
+ * shape frames x antennas x chirps x samples) through radar_processing_feed, see Makefile:
+ *
+ *   ./radar_replay [options] [radar.npy]
+ *
+ *   -f			fixed point arithmetic
+ *   -k			keep the range-Doppler map (fixed point)
+ *   -m alpha	MTI background update factor
+ *   -c			CFAR detection (CFAR_CONFIG_DEFAULT), -o for the OS-CFAR variant
+ *   -r width	ROI tracking half width (full scan every 8 frames)
+ *   -p factor	pre-screen factor
+ *   -g limit	motion gate threshold (ADC LSB)
+ *   -s chirps	stream the frames by blocks of chirps (radar_processing_feed_chirps)
+ *   -n count	replay the recording count times and print the time per frame only
+ *   -t count	check radar_processing_feed_targets (up to count targets) instead, see below
+ *
+ * One line per frame: frame, status, amplitude, range bin, azimuth, elevation (and the CFAR detections).
+ *
+ * With -t, one line per frame: frame, target count, targets (range bin, velocity bin, amplitude). Each frame is given to three instances:
+ * radar_processing_feed_targets with the options, radar_processing_feed_targets without the pre-screen and the ROI tracking,
+ * and radar_processing_feed without the ROI tracking (which reports the peak of the region of interest, not of the map).
+ * Both target lists must be identical and target 0 must be the result of radar_processing_feed (FAIL lines on stderr, exit status 1 otherwise).
+ * The default file is the recording of the repository (radar_dsp/data/sample_1), the chirp configuration
+ * (2 MHz, 61.02 GHz to 61.48 GHz) is the one of its config.json.
+ *
+ * Rutronik Elektronische Bauelemente GmbH Disclaimer: The evaluation board
+ * including the software is for testing purposes only and,
+ * because it has limited functions and limited resilience, is not suitable
+ * for permanent use under real conditions. If the evaluation board is
+ * nevertheless used under real conditions, this is done at one’s responsibility;
+ * any liability of Rutronik is insofar excluded
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "radar_processing.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define REPLAY_DEFAULT_FILE "../../../data/sample_1/RadarIfxAvian_00/radar.npy"
+#define REPLAY_SAMPLING_RATE 2000000
+#define REPLAY_START_FREQ 61020000000ULL
+#define REPLAY_END_FREQ 61480000000ULL
+
+typedef struct
+{
+	uint16_t* samples;
+	uint32_t frames;
+	uint32_t antennas;
+	uint32_t chirps;
+	uint32_t samples_per_chirp;
+} recording_t;
+
+/**
+ * @brief Read a .npy file of uint16, 4 dimensions, C order
+ *
+ * @retval 0	Success
+ * @retval -1	File not readable
+ * @retval -2	Format not supported
+ */
+static int recording_load(const char* path, recording_t* recording)
+{
+	FILE* file = fopen(path, "rb");
+	if (file == NULL) return -1;
+
+	// Magic, version, header length (v1: 16 bits, v2 / v3: 32 bits)
+	uint8_t preamble[12];
+	if (fread(preamble, 1, 10, file) != 10 || memcmp(preamble, "\x93NUMPY", 6) != 0)
+	{
+		fclose(file);
+		return -2;
+	}
+
+	uint32_t header_len = preamble[8] | ((uint32_t)preamble[9] << 8);
+	if (preamble[6] >= 2)
+	{
+		if (fread(&preamble[10], 1, 2, file) != 2)
+		{
+			fclose(file);
+			return -2;
+		}
+		header_len |= ((uint32_t)preamble[10] << 16) | ((uint32_t)preamble[11] << 24);
+	}
+	if (header_len > 4096)
+	{
+		fclose(file);
+		return -2;
+	}
+
+	char header[4097];
+	if (fread(header, 1, header_len, file) != header_len)
+	{
+		fclose(file);
+		return -2;
+	}
+	header[header_len] = '\0';
+
+	const char* shape = strstr(header, "'shape':");
+	unsigned dims[4];
+	if ((strstr(header, "'descr': '<u2'") == NULL) || (strstr(header, "'fortran_order': False") == NULL) || (shape == NULL)
+			|| (sscanf(shape, "'shape': (%u, %u, %u, %u)", &dims[0], &dims[1], &dims[2], &dims[3]) != 4))
+	{
+		fclose(file);
+		return -2;
+	}
+
+	const size_t count = (size_t)dims[0] * dims[1] * dims[2] * dims[3];
+	recording->samples = malloc(count * sizeof(uint16_t));
+	if ((recording->samples == NULL) || (fread(recording->samples, sizeof(uint16_t), count, file) != count))
+	{
+		free(recording->samples);
+		fclose(file);
+		return -2;
+	}
+	fclose(file);
+
+	recording->frames = dims[0];
+	recording->antennas = dims[1];
+	recording->chirps = dims[2];
+	recording->samples_per_chirp = dims[3];
+	return 0;
+}
+
+/**
+ * @brief Frame of the recording in the layout of the sensor FIFO: frame[chirp][sample][antenna]
+ */
+static void recording_frame(const recording_t* recording, uint32_t frame_idx, uint16_t* frame)
+{
+	const uint32_t antennas = recording->antennas;
+	const uint32_t chirps = recording->chirps;
+	const uint32_t samples = recording->samples_per_chirp;
+	const uint16_t* src = &recording->samples[(size_t)frame_idx * antennas * chirps * samples];
+
+	for (uint32_t antenna = 0; antenna < antennas; ++antenna)
+	{
+		for (uint32_t chirp = 0; chirp < chirps; ++chirp)
+		{
+			for (uint32_t sample = 0; sample < samples; ++sample)
+			{
+				frame[(chirp * samples + sample) * antennas + antenna] = src[(antenna * chirps + chirp) * samples + sample];
+			}
+		}
+	}
+}
+
+static double now_us(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec * 1e-3;
+}
+
+/**
+ * @brief Feed one frame, whole or by blocks of stream_block chirps (0 -> radar_processing_feed)
+ */
+static int feed(radar_processing_t* handle, uint16_t* frame, const recording_t* recording, uint16_t stream_block,
+		radar_processing_out_t* result)
+{
+	if (stream_block == 0) return radar_processing_feed(handle, frame, result);
+
+	const uint32_t chirp_len = recording->antennas * recording->samples_per_chirp;
+	for (uint16_t first = 0; first < recording->chirps; first += stream_block)
+	{
+		const uint16_t count = ((first + stream_block) <= recording->chirps) ? stream_block : (uint16_t)(recording->chirps - first);
+		const int status = radar_processing_feed_chirps(handle, &frame[first * chirp_len], first, count);
+		if (status != 0) return status;
+	}
+
+	return radar_processing_feed_finish(handle, frame, result);
+}
+
+/**
+ * @brief Instance inside of memory allocated for it (freed with free(*memory))
+ *
+ * @retval Instance, NULL on error (printed)
+ */
+static radar_processing_t* instance_create(const radar_configuration_t* config, void** memory)
+{
+	const size_t memory_size = radar_processing_memory_requirement(config);
+	*memory = aligned_alloc(RADAR_PROCESSING_MEMORY_ALIGNMENT,
+			(memory_size + RADAR_PROCESSING_MEMORY_ALIGNMENT - 1) & ~(size_t)(RADAR_PROCESSING_MEMORY_ALIGNMENT - 1));
+	radar_processing_t* handle = NULL;
+
+	const int init_status = (*memory != NULL) ? radar_processing_init(&handle, config, *memory, memory_size) : -5;
+	if (init_status != 0)
+	{
+		fprintf(stderr, "radar_processing_init: %d\n", init_status);
+		return NULL;
+	}
+
+	return handle;
+}
+
+static bool target_equal(const radar_processing_target_t* a, const radar_processing_target_t* b)
+{
+	return (a->amplitude == b->amplitude) && (a->range == b->range) && (a->velocity == b->velocity)
+			&& (a->azimuth == b->azimuth) && (a->elevation == b->elevation);
+}
+
+/**
+ * @brief Check of radar_processing_feed_targets on every frame of the recording (see -t)
+ *
+ * @retval Number of frames that failed
+ */
+static uint32_t check_targets(const recording_t* recording, const radar_configuration_t* config, uint16_t* frame, uint16_t max_targets)
+{
+	// radar_processing_feed: full scan of the map, reference: without the pre-screen either
+	radar_configuration_t feed_config = *config;
+	feed_config.roi_half_width = 0;
+	feed_config.roi_full_scan_period = 0;
+	radar_configuration_t reference_config = feed_config;
+	reference_config.prescreen_factor = 0;
+
+	void* memory[3] = { NULL, NULL, NULL };
+	radar_processing_t* feed_handle = instance_create(&feed_config, &memory[0]);
+	radar_processing_t* targets_handle = instance_create(config, &memory[1]);
+	radar_processing_t* reference_handle = instance_create(&reference_config, &memory[2]);
+	radar_processing_target_t* targets = malloc(2U * max_targets * sizeof(radar_processing_target_t));
+	radar_processing_target_t* reference = &targets[max_targets];
+	const bool created = (feed_handle != NULL) && (targets_handle != NULL) && (reference_handle != NULL) && (targets != NULL);
+	uint32_t failures = created ? 0 : recording->frames;
+
+	for (uint32_t frame_idx = 0; (frame_idx < recording->frames) && created; ++frame_idx)
+	{
+		radar_processing_out_t result = { 0 };
+		recording_frame(recording, frame_idx, frame);
+		const int status = radar_processing_feed(feed_handle, frame, &result);
+		recording_frame(recording, frame_idx, frame);
+		const int count = radar_processing_feed_targets(targets_handle, frame, targets, max_targets);
+		recording_frame(recording, frame_idx, frame);
+		const int reference_count = radar_processing_feed_targets(reference_handle, frame, reference, max_targets);
+
+		printf("%u %d", frame_idx, count);
+		for (int i = 0; i < count; ++i)
+		{
+			printf(" (%.0f,%.0f,%.4f)", targets[i].range, targets[i].velocity, targets[i].amplitude);
+		}
+		printf("\n");
+
+		if ((status < 0) || (count < 0) || (reference_count < 0))
+		{
+			fprintf(stderr, "FAIL frame %u: status %d, %d targets, %d reference targets\n", frame_idx, status, count, reference_count);
+			failures++;
+			continue;
+		}
+
+		// Target 0 <-> result of radar_processing_feed (range 0 -> nothing detected, CFAR amplitude: maximum of the map)
+		bool same = (count > 0) ? ((targets[0].range == result.range) && (targets[0].azimuth == result.azimuth)
+				&& (targets[0].elevation == result.elevation)
+				&& ((config->detection == RADAR_PROCESSING_DETECTION_CFAR) || (targets[0].amplitude == result.amplitude)))
+				: (result.range == 0);
+		if (!same)
+		{
+			fprintf(stderr, "FAIL frame %u: feed %.0f %.6f %.5f %.5f\n", frame_idx, result.range, result.amplitude, result.azimuth, result.elevation);
+		}
+
+		bool same_list = (count == reference_count);
+		for (int i = 0; (i < count) && same_list; ++i)
+		{
+			same_list = target_equal(&targets[i], &reference[i]);
+		}
+		if (!same_list)
+		{
+			fprintf(stderr, "FAIL frame %u: %d reference targets", frame_idx, reference_count);
+			for (int i = 0; i < reference_count; ++i)
+			{
+				fprintf(stderr, " (%.0f,%.0f,%.4f)", reference[i].range, reference[i].velocity, reference[i].amplitude);
+			}
+			fprintf(stderr, "\n");
+		}
+
+		if (!same || !same_list) failures++;
+	}
+
+	radar_processing_deinit(feed_handle);
+	radar_processing_deinit(targets_handle);
+	radar_processing_deinit(reference_handle);
+	free(targets);
+	for (int i = 0; i < 3; ++i) free(memory[i]);
+
+	return failures;
+}
+
+int main(int argc, char** argv)
+{
+	radar_configuration_t config = { 0 };
+	bool cfar = false;
+	bool cfar_os = false;
+	uint16_t stream_block = 0;
+	uint32_t repetitions = 0;
+	uint16_t max_targets = 0;
+	int option;
+
+	while ((option = getopt(argc, argv, "fkm:cor:p:g:s:n:t:")) != -1)
+	{
+		switch (option)
+		{
+		case 'f': config.arithmetic = RADAR_PROCESSING_FIXED_POINT; break;
+		case 'k': config.keep_doppler_map = true; break;
+		case 'm': config.mti_alpha = strtof(optarg, NULL); break;
+		case 'c': cfar = true; break;
+		case 'o': cfar_os = true; break;
+		case 'r': config.roi_half_width = (uint16_t)atoi(optarg); config.roi_full_scan_period = 8; break;
+		case 'p': config.prescreen_factor = strtof(optarg, NULL); break;
+		case 'g': config.motion_threshold = strtof(optarg, NULL); break;
+		case 's': stream_block = (uint16_t)atoi(optarg); break;
+		case 'n': repetitions = (uint32_t)atoi(optarg); break;
+		case 't': max_targets = (uint16_t)atoi(optarg); break;
+		default:
+			fprintf(stderr, "usage: %s [-f] [-k] [-m alpha] [-c [-o]] [-r width] [-p factor] [-g limit] [-s chirps] [-n count] [-t count] [radar.npy]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	const char* path = (optind < argc) ? argv[optind] : REPLAY_DEFAULT_FILE;
+	recording_t recording;
+	const int load_status = recording_load(path, &recording);
+	if (load_status != 0)
+	{
+		fprintf(stderr, "%s: %s\n", path, (load_status == -1) ? "cannot be read" : "not a uint16 4D .npy file");
+		return 1;
+	}
+
+	config.antenna_count = (uint8_t)recording.antennas;
+	config.chirps_per_frame = (uint16_t)recording.chirps;
+	config.samples_per_chirp = (uint16_t)recording.samples_per_chirp;
+	config.sampling_rate = REPLAY_SAMPLING_RATE;
+	config.start_freq = REPLAY_START_FREQ;
+	config.end_freq = REPLAY_END_FREQ;
+	if (cfar)
+	{
+		const cfar_config_t cfar_default = CFAR_CONFIG_DEFAULT;
+		config.detection = RADAR_PROCESSING_DETECTION_CFAR;
+		config.cfar = cfar_default;
+		if (cfar_os)
+		{
+			config.cfar.mode = CFAR_MODE_OS;
+			config.cfar.os_rank = 5;
+		}
+	}
+
+	uint16_t* frame = malloc((size_t)recording.antennas * recording.chirps * recording.samples_per_chirp * sizeof(uint16_t));
+	if (frame == NULL) return 1;
+
+	if (max_targets > 0)
+	{
+		printf("# %s: %u frames, up to %u targets\n", path, recording.frames, max_targets);
+		const uint32_t failures = check_targets(&recording, &config, frame, max_targets);
+		if (failures != 0) fprintf(stderr, "FAILED: %u of %u frames\n", failures, recording.frames);
+
+		free(frame);
+		free(recording.samples);
+		return (failures != 0) ? 1 : 0;
+	}
+
+	void* memory = NULL;
+	radar_processing_t* handle = instance_create(&config, &memory);
+	if (handle == NULL) return 1;
+
+	printf("# %s: %u frames, %u antennas, %u chirps, %u samples, instance %zu bytes\n", path,
+			recording.frames, recording.antennas, recording.chirps, recording.samples_per_chirp, radar_processing_memory_requirement(&config));
+
+	if (repetitions == 0)
+	{
+		// Results of each frame
+		double total = 0;
+		for (uint32_t frame_idx = 0; frame_idx < recording.frames; ++frame_idx)
+		{
+			radar_processing_out_t result = { 0 };
+			recording_frame(&recording, frame_idx, frame);
+
+			const double start = now_us();
+			const int status = feed(handle, frame, &recording, stream_block, &result);
+			total += now_us() - start;
+
+			printf("%u %d %.6f %.0f %.5f %.5f", frame_idx, status, result.amplitude, result.range, result.azimuth, result.elevation);
+			if (config.detection == RADAR_PROCESSING_DETECTION_CFAR)
+			{
+				uint16_t count = 0;
+				const cfar_detection_t* detections = radar_processing_get_detections(handle, &count);
+				printf(" %u", count);
+				for (uint16_t i = 0; i < count; ++i)
+				{
+					printf(" (%u,%u,%.1f dB)", detections[i].bin, detections[i].velocity, detections[i].snr);
+				}
+			}
+			printf("\n");
+		}
+		printf("# %.2f us/frame\n", total / recording.frames);
+	}
+	else
+	{
+		// Throughput only (frames reordered once, out of the measurement)
+		uint16_t* frames = malloc((size_t)recording.frames * recording.antennas * recording.chirps * recording.samples_per_chirp * sizeof(uint16_t));
+		if (frames == NULL) return 1;
+		const size_t frame_len = (size_t)recording.antennas * recording.chirps * recording.samples_per_chirp;
+		for (uint32_t frame_idx = 0; frame_idx < recording.frames; ++frame_idx)
+		{
+			recording_frame(&recording, frame_idx, &frames[frame_idx * frame_len]);
+		}
+
+		const double start = now_us();
+		for (uint32_t repetition = 0; repetition < repetitions; ++repetition)
+		{
+			for (uint32_t frame_idx = 0; frame_idx < recording.frames; ++frame_idx)
+			{
+				radar_processing_out_t result;
+				memcpy(frame, &frames[frame_idx * frame_len], frame_len * sizeof(uint16_t));
+				feed(handle, frame, &recording, stream_block, &result);
+			}
+		}
+		printf("# %.2f us/frame (%u frames)\n", (now_us() - start) / ((double)recording.frames * repetitions), recording.frames * repetitions);
+		free(frames);
+	}
+
+	radar_processing_deinit(handle);
+	free(frame);
+	free(memory);
+	free(recording.samples);
+	return 0;
+}
@@ -0,0 +1,97 @@
+/*
+ * range_fft_bench.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ * Host (x86 / Linux) comparison of range_fft_gated_do and range_fft_paired_do, see Makefile:
+ *
+ *   ./range_fft_bench [samples per chirp] [chirps per frame]
+ *
+ * Best time of one range FFT call over the frame (3 antennas, complete range), for both layouts and
+ * for the antenna masks 0b011 (one pair) and 0b111 (one pair and one real FFT).
+ *
+ * Rutronik Elektronische Bauelemente GmbH Disclaimer: The evaluation board
+ * including the software is for testing purposes only and,
+ * because it has limited functions and limited resilience, is not suitable
+ * for permanent use under real conditions. If the evaluation board is
+ * nevertheless used under real conditions, this is done at one’s responsibility;
+ * any liability of Rutronik is insofar excluded
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "range_fft.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_ANTENNAS 3
+#define BENCH_CALLS 100
+#define BENCH_REPETITIONS 50
+
+static double now_us(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec * 1e-3;
+}
+
+int main(int argc, char** argv)
+{
+	const uint16_t samples = (argc > 1) ? (uint16_t)atoi(argv[1]) : 64;
+	const uint16_t chirps = (argc > 2) ? (uint16_t)atoi(argv[2]) : 64;
+	const uint32_t frame_len = (uint32_t)BENCH_ANTENNAS * chirps * samples;
+
+	uint16_t* frame = malloc(frame_len * sizeof(uint16_t));
+	cfloat32_t* range = malloc((size_t)BENCH_ANTENNAS * chirps * (samples / 2) * sizeof(cfloat32_t));
+	float32_t* work = malloc(2U * samples * sizeof(float32_t));
+	float32_t* window = malloc(samples * sizeof(float32_t));
+	if ((frame == NULL) || (range == NULL) || (work == NULL) || (window == NULL)) return 1;
+
+	// 12 bits noise, Blackman Harris window
+	srand(1);
+	for (uint32_t i = 0; i < frame_len; ++i) frame[i] = (uint16_t)(rand() % 4096);
+	ifx_window_blackmanharris_f32(window, samples);
+	range_fft_window_init(window, window, samples);
+
+	printf("# %u samples per chirp, %u chirps per frame, %d antennas\n", samples, chirps, BENCH_ANTENNAS);
+	for (int layout = 0; layout < 2; ++layout)
+	{
+		range_fft_ctx_t ctx;
+		const range_fft_layout_t cube_layout = (layout == 0) ? RANGE_FFT_LAYOUT_CHIRP_MAJOR : RANGE_FFT_LAYOUT_BIN_MAJOR;
+		if (range_fft_ctx_init(&ctx, samples, 0, samples / 2, cube_layout) != 0) return 1;
+
+		for (uint8_t mask = 3; mask <= 7; mask += 4)
+		{
+			double gated = 1e9;
+			double paired = 1e9;
+			for (int repetition = 0; repetition < BENCH_REPETITIONS; ++repetition)
+			{
+				double start = now_us();
+				for (int call = 0; call < BENCH_CALLS; ++call)
+				{
+					range_fft_gated_do(&ctx, frame, range, work, true, window, BENCH_ANTENNAS, mask, chirps);
+				}
+				double time = (now_us() - start) / BENCH_CALLS;
+				if (time < gated) gated = time;
+
+				start = now_us();
+				for (int call = 0; call < BENCH_CALLS; ++call)
+				{
+					range_fft_paired_do(&ctx, frame, range, work, true, window, BENCH_ANTENNAS, mask, chirps);
+				}
+				time = (now_us() - start) / BENCH_CALLS;
+				if (time < paired) paired = time;
+			}
+
+			printf("%s mask 0x%x: gated %.1f us, paired %.1f us\n", (layout == 0) ? "chirp major" : "bin major", mask, gated, paired);
+		}
+	}
+
+	free(frame);
+	free(range);
+	free(work);
+	free(window);
+	return 0;
+}
@@ -62,17 +62,90 @@
 #define XENSIV_BGT60TRXX_CONF_IMPL
 #include "radar_settings.h"
 
+#include "radar_processing.h"
+#include "frame_pool.h"
+#include "binlog.h"
+
 // Compute how many samples a frame contains
 #define NUM_SAMPLES_PER_FRAME (XENSIV_BGT60TRXX_CONF_NUM_SAMPLES_PER_CHIRP * XENSIV_BGT60TRXX_CONF_NUM_CHIRPS_PER_FRAME * XENSIV_BGT60TRXX_CONF_NUM_RX_ANTENNAS)
 
+// Chirps read from the FIFO per interrupt: the range FFT of a block runs while the next chirps are acquired,
+// so only the Doppler stage and the detection are left once the last chirp of the frame is read
+#define NUM_CHIRPS_PER_BLOCK 4
+#define NUM_SAMPLES_PER_CHIRP (XENSIV_BGT60TRXX_CONF_NUM_SAMPLES_PER_CHIRP * XENSIV_BGT60TRXX_CONF_NUM_RX_ANTENNAS)
+#define NUM_SAMPLES_PER_BLOCK (NUM_SAMPLES_PER_CHIRP * NUM_CHIRPS_PER_BLOCK)
+
+#if (XENSIV_BGT60TRXX_CONF_NUM_CHIRPS_PER_FRAME % NUM_CHIRPS_PER_BLOCK) != 0
+#error "NUM_CHIRPS_PER_BLOCK must divide the number of chirps per frame"
+#endif
+
+// Memory of the radar processing instance (see radar_processing_memory_requirement)
+#define RADAR_PROCESSING_MEMORY_SIZE (16U * 1024U)
+
+// If defined, the CPU cycles of the radar processing of each frame are measured with the DWT cycle counter
+// and logged (LOG_CYCLES): sum of the radar_processing_feed_chirps calls (range FFT) and radar_processing_feed_finish
+#undef RADAR_PROCESSING_MEASURE_CYCLES
+
 static cyhal_spi_t spi;
 static xensiv_bgt60trxx_mtb_t bgt60_obj;
 
-static uint16_t data_available = 0;
+static radar_processing_t* processing = NULL;
+static uint8_t processing_memory[RADAR_PROCESSING_MEMORY_SIZE] __attribute__((aligned(RADAR_PROCESSING_MEMORY_ALIGNMENT)));
+
+// Frames read by radar_isr and processed by the main loop (no copy: the FIFO is read directly inside of the pool)
+static frame_pool_t frame_pool;
+static uint16_t frame_memory[FRAME_POOL_SIZE * NUM_SAMPLES_PER_FRAME];
+
+// Destination of the blocks of a dropped frame (FIFO emptied anyway)
+static uint16_t block_discard[NUM_SAMPLES_PER_BLOCK];
+
+static volatile bool fifo_error = false;
+
+// Messages of the binary log (decoded on the host by src/python/binlog_decode.py)
+#define RADAR_LOG_MESSAGES(X) \
+	X(LOG_RADAR_ISR, 1, "isr called, chirp %u, frame %u") \
+	X(LOG_FRAMES_DROPPED, 2, "frames dropped: %u") \
+	X(LOG_TARGET, 3, "%f;%f;%f;%f") \
+	X(LOG_CYCLES, 4, "cycles: range %u, finish %u")
+
+enum { RADAR_LOG_MESSAGES(BINLOG_ENUM) };
+
+// Records not sent yet (sent by the main loop while it waits for chirps)
+#define LOG_RECORD_COUNT 64U
+#define LOG_RECORDS_PER_FLUSH 4U
+
+static binlog_t radar_log;
+static binlog_record_t log_records[LOG_RECORD_COUNT];
+
+static uint32_t _log_timestamp(void)
+{
+	return (uint32_t)clock_get_tick();
+}
+
+static void _log_output(const uint8_t* data, uint32_t len)
+{
+	fwrite(data, 1, len, stdout);
+	fflush(stdout);
+}
+
+#ifdef RADAR_PROCESSING_MEASURE_CYCLES
+static void _cycles_init(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static inline uint32_t _cycles_get(void)
+{
+	return DWT->CYCCNT;
+}
+#endif
 
 /**
- * @brief Interrupt service routine called when radar values (a frame) are available
+ * @brief Interrupt service routine called when radar values (a block of chirps) are available
  *
+ * Reads the block into the frame being acquired, the main loop processes the chirps already read.
  * See xensiv_bgt60trxx_mtb_interrupt_init
  */
 void radar_isr(void *args, cyhal_gpio_event_t event)
@@ -80,10 +153,24 @@ void radar_isr(void *args, cyhal_gpio_event_t event)
     CY_UNUSED_PARAMETER(args);
     CY_UNUSED_PARAMETER(event);
 
+    // No free frame (processing too slow) -> the frame is dropped and counted by the pool
+    uint16_t* block = frame_pool_producer_block(&frame_pool);
+    if (block == NULL)
+    {
+    	block = block_discard;
+    }
+
     // Values are available, then can be read using the function xensiv_bgt60trxx_get_fifo_data
-    data_available = 1;
+    if (xensiv_bgt60trxx_get_fifo_data(&bgt60_obj.dev, block, NUM_SAMPLES_PER_BLOCK) != XENSIV_BGT60TRXX_STATUS_OK)
+    {
+    	fifo_error = true;
+    	return;
+    }
 
-    printf("isr called\r\n");
+    // Stored only, formatted on the host
+    binlog_write(&radar_log, LOG_RADAR_ISR, 2, frame_pool.position, frame_pool.write, 0, 0);
+
+    frame_pool_producer_commit(&frame_pool, NUM_CHIRPS_PER_BLOCK);
 }
 
 /**
@@ -150,9 +237,9 @@ static bool _init_bgt60tr13c()
         return false;
     }
 
-	// The sensor will generate an interrupt once the sensor FIFO level is NUM_SAMPLES_PER_FRAME
+	// The sensor will generate an interrupt once the sensor FIFO level is NUM_SAMPLES_PER_BLOCK
 	result = xensiv_bgt60trxx_mtb_interrupt_init(&bgt60_obj,
-			NUM_SAMPLES_PER_FRAME,
+			NUM_SAMPLES_PER_BLOCK,
 			CYBSP_RSPI_IRQ,
 			CYHAL_ISR_PRIORITY_DEFAULT,
 			radar_isr,
@@ -166,6 +253,39 @@ static bool _init_bgt60tr13c()
     return true;
 }
 
+/**
+ * @brief Create the radar processing instance for the configuration of the sensor
+ *
+ * @retval true on success
+ */
+static bool _init_processing()
+{
+	radar_configuration_t configuration;
+	memset(&configuration, 0, sizeof(configuration));
+
+	configuration.antenna_count = XENSIV_BGT60TRXX_CONF_NUM_RX_ANTENNAS;
+	configuration.chirps_per_frame = XENSIV_BGT60TRXX_CONF_NUM_CHIRPS_PER_FRAME;
+	configuration.samples_per_chirp = XENSIV_BGT60TRXX_CONF_NUM_SAMPLES_PER_CHIRP;
+	configuration.sampling_rate = XENSIV_BGT60TRXX_CONF_SAMPLE_RATE;
+	configuration.start_freq = XENSIV_BGT60TRXX_CONF_START_FREQ_HZ;
+	configuration.end_freq = XENSIV_BGT60TRXX_CONF_END_FREQ_HZ;
+	configuration.arithmetic = RADAR_PROCESSING_FLOAT32;
+
+	if (radar_processing_memory_requirement(&configuration) > sizeof(processing_memory))
+	{
+		printf("ERROR: radar processing needs %u bytes\r\n", (unsigned int)radar_processing_memory_requirement(&configuration));
+		return false;
+	}
+
+	if (radar_processing_init(&processing, &configuration, processing_memory, sizeof(processing_memory)) != 0)
+	{
+		printf("ERROR: radar_processing_init\r\n");
+		return false;
+	}
+
+	return true;
+}
+
 
 int main(void)
 {
@@ -199,6 +319,29 @@ int main(void)
     	return 0;
     }
 
+    if (binlog_init(&radar_log, log_records, LOG_RECORD_COUNT, _log_timestamp) != 0)
+    {
+    	printf("init log error\r\n");
+    	return 0;
+    }
+
+    if (frame_pool_init(&frame_pool, frame_memory, XENSIV_BGT60TRXX_CONF_NUM_CHIRPS_PER_FRAME, NUM_SAMPLES_PER_CHIRP) != 0)
+    {
+    	printf("init frame pool error\r\n");
+    	return 0;
+    }
+
+    if (!_init_processing())
+    {
+    	printf("init processing error\r\n");
+    	return 0;
+    }
+
+#ifdef RADAR_PROCESSING_MEASURE_CYCLES
+    _cycles_init();
+    uint32_t range_cycles = 0;
+#endif
+
     printf("all fine so far\r\n");
 
     // start frames
@@ -210,17 +353,65 @@ int main(void)
 
     printf("frames are started\r\n");
 
-    uint16_t buffer_raw[NUM_SAMPLES_PER_FRAME];
+    uint16_t chirp_idx = 0;
+    uint32_t overruns = 0;
 
     for(;;)
     {
-    	if (data_available)
+    	if (fifo_error)
+    	{
+    		printf("xensiv_bgt60trxx_get_fifo_data error\r\n");
+    		for(;;){}
+    	}
+
+    	if (frame_pool_overruns(&frame_pool) != overruns)
+    	{
+    		overruns = frame_pool_overruns(&frame_pool);
+    		binlog_write(&radar_log, LOG_FRAMES_DROPPED, 1, overruns, 0, 0, 0);
+    	}
+
+    	// Oldest frame of the pool, possibly still being acquired
+    	uint16_t chirps_available = 0;
+    	uint16_t* frame = frame_pool_consumer_peek(&frame_pool, &chirps_available);
+    	if ((frame == NULL) || (chirps_available == chirp_idx))
+    	{
+    		// Nothing to process: send a few log records
+    		binlog_flush(&radar_log, _log_output, LOG_RECORDS_PER_FLUSH);
+    		continue;
+    	}
+
+    	// Range FFT of the chirps read since the last pass while the sensor acquires the next ones
+#ifdef RADAR_PROCESSING_MEASURE_CYCLES
+    	if (chirp_idx == 0) range_cycles = 0;
+    	const uint32_t range_start = _cycles_get();
+#endif
+    	radar_processing_feed_chirps(processing, &frame[chirp_idx * NUM_SAMPLES_PER_CHIRP], chirp_idx, chirps_available - chirp_idx);
+    	chirp_idx = chirps_available;
+#ifdef RADAR_PROCESSING_MEASURE_CYCLES
+    	range_cycles += _cycles_get() - range_start;
+#endif
+
+    	if (chirp_idx == XENSIV_BGT60TRXX_CONF_NUM_CHIRPS_PER_FRAME)
     	{
-    		data_available = 0;
-    		if (xensiv_bgt60trxx_get_fifo_data(&bgt60_obj.dev, buffer_raw, NUM_SAMPLES_PER_FRAME) != XENSIV_BGT60TRXX_STATUS_OK)
+    		// Frame complete: Doppler stage, detection and angles (the complete frame is used by the motion gate and the angles)
+    		chirp_idx = 0;
+
+    		radar_processing_out_t result;
+#ifdef RADAR_PROCESSING_MEASURE_CYCLES
+    		const uint32_t finish_start = _cycles_get();
+#endif
+    		const int status = radar_processing_feed_finish(processing, frame, &result);
+#ifdef RADAR_PROCESSING_MEASURE_CYCLES
+    		binlog_write(&radar_log, LOG_CYCLES, 2, range_cycles, _cycles_get() - finish_start, 0, 0);
+#endif
+
+    		// The acquisition can now reuse the frame
+    		frame_pool_consumer_release(&frame_pool);
+
+    		if ((status == RADAR_PROCESSING_FRAME_PROCESSED) && (result.range != 0))
     		{
-    			printf("xensiv_bgt60trxx_get_fifo_data error\r\n");
-    			for(;;){}
+    			binlog_write(&radar_log, LOG_TARGET, 4, binlog_float(result.amplitude), binlog_float(result.range),
+    					binlog_float(result.azimuth), binlog_float(result.elevation));
     		}
     	}
     }
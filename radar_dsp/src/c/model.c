@@ -7,8 +7,8 @@
 * Model ID  6f278933-bbbb-451e-80c3-7daf9f3e76aa
 * 
 * Memory    Size                      Efficiency
-* Buffers   396 bytes (RAM)           100 %
-* State     17008 bytes (RAM)         100 %
+* Buffers   0 bytes (RAM)             100 %
+* State     17616 bytes (RAM)         100 %
 * Readonly  151776 bytes (Flash)      100 %
 * 
 * Exported functions:
@@ -23,6 +23,9 @@
 *  @return IPWIN_RET_SUCCESS (0) or IPWIN_RET_NODATA (-1), IPWIN_RET_ERROR (-2), IPWIN_RET_STREAMEND (-3)
 *  int IMAI_enqueue(const float *data_in);
 * 
+*  @description: Drops the data enqueued so far and the LSTM state (e.g. after a gap in the input stream).
+*  void IMAI_reset(void);
+* 
 *  @description: Closes and flushes streams, free any heap allocated memory.
 *  void IMAI_finalize(void);
 * 
@@ -61,6 +64,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
+#include <stdatomic.h>
 #include "cy_retarget_io.h"
 #include "mtb_ml_model.h"
 #include "mtb_ml_utils.h"
@@ -81,8 +85,7 @@
 #endif
 
 // Working memory
-static ALIGNED(16) int8_t _buffer[396];
-static ALIGNED(16) int8_t _state[17008];
+static ALIGNED(16) int8_t _state[17616];
 
 // Parameters
 static const ALIGNED(16) uint32_t _K4[] = {
@@ -4833,16 +4836,22 @@ static const ALIGNED(16) uint32_t _K4[] = {
 
 // Memory mapped buffers
 #define _K4              ((uint8_t *)_K4)                    // u8[151776] (151776 bytes)
-#define _K2              ((int8_t *)(_state + 0x00000000))   // s8[604] (604 bytes)
-#define _K3              ((uint8_t *)(_state + 0x00000270))  // u8[16384] (16384 bytes)
-#define _K7              ((int8_t *)(_state + 0x0000025c))   // s8[8] (8 bytes)
-#define _K1              ((float *)(_buffer + 0x00000000))   // f32[33,3] (396 bytes)
+#define _K2              ((int8_t *)(_state + 0x00000000))   // s8[1216] (1216 bytes)
+#define _K3              ((uint8_t *)(_state + 0x000004d0))  // u8[16384] (16384 bytes)
+#define _K7              ((int8_t *)(_state + 0x000004c0))   // s8[8] (8 bytes)
 
 #define IPWIN_RET_SUCCESS 0
 #define IPWIN_RET_NODATA -1
 #define IPWIN_RET_ERROR -2
 #define IPWIN_RET_STREAMEND -3
 
+// The interpreter keeps the LSTM state (variable tensors) from one window to the next.
+// Number of windows after which this state is cleared: 1 -> every window starts from a zero state (as during the training),
+// N -> state carried over N windows, 0 -> only cleared by IMAI_reset.
+#ifndef IMAI_RNN_RESYNC_WINDOWS
+	#define IMAI_RNN_RESYNC_WINDOWS 1
+#endif
+
 #ifdef IMAI_PROFILING
 	#define __HOOK_REGION(entered, region_id) hook_region(entered, region_id)
 	#define __CLOSE_HOOKS() close_regions()
@@ -4879,136 +4888,91 @@ static const ALIGNED(16) uint32_t _K4[] = {
 	#define __CLOSE_HOOKS() do { } while(0)
 #endif
 
-// Represents a Circular Buffer
+// Single producer / single consumer ring of float rows
 // https://en.wikipedia.org/wiki/Circular_buffer
+// Capacity is a power of two (index = count & mask), head and tail only grow: the producer (e.g. sensor task or ISR)
+// and the consumer (inference task) can run concurrently without critical section.
+// The first "mirror" rows are also written after the end of the ring, so "mirror + 1" rows from any read
+// position are contiguous (windows are read in place).
 typedef struct
 {
-	char *buf;
-	int size;		// total bytes allocated in *buf
-	int used;		// current bytes used in buffer.
-	int read;
-	int write;
-} cbuffer_t;
+	float *buf;						// (capacity + mirror) * row_size floats
+	uint32_t row_size;				// floats per row
+	uint32_t mask;					// capacity - 1 (rows)
+	uint32_t mirror;				// rows copied after the end of the ring
+	atomic_uint_fast32_t head;		// rows written (producer)
+	atomic_uint_fast32_t tail;		// rows released (consumer)
+} ring_t;
 
-#define CBUFFER_SUCCESS 0
-#define CBUFFER_NOMEM -1
-
-// Reset instance (clear buffer)
-static inline void cbuffer_reset(cbuffer_t* buf) {
-	buf->read = 0;
-	buf->write = 0;
-	buf->used = 0;
-}
+#define RING_SUCCESS 0
+#define RING_NOMEM -1
 
-// Initializes a cbuffer handle with given memory and size.
-static inline void cbuffer_init(cbuffer_t *dest, void *mem, int size) {
-	dest->buf = mem;
-	dest->size = size;
-	cbuffer_reset(dest);
+// Number of rows needed to hold "count" rows (power of two).
+static inline uint32_t ring_capacity(uint32_t count) {
+	uint32_t capacity = 1;
+	while (capacity < count)
+		capacity <<= 1;
+	return capacity;
 }
 
-// Returns the number of free bytes in buffer.
-static inline int cbuffer_get_free(cbuffer_t *buf) {
-	return buf->size - buf->used;
+// Initializes a ring with given memory ((capacity + mirror) * row_size floats), capacity is a power of two.
+static inline void ring_init(ring_t *ring, float *mem, uint32_t row_size, uint32_t capacity, uint32_t mirror) {
+	ring->buf = mem;
+	ring->row_size = row_size;
+	ring->mask = capacity - 1;
+	ring->mirror = mirror;
+	atomic_init(&ring->head, 0);
+	atomic_init(&ring->tail, 0);
 }
 
-// Returns the number of used bytes in buffer.
-static inline int cbuffer_get_used(cbuffer_t *buf) {
-	return buf->used;
+// Returns the number of rows available to the consumer.
+static inline uint32_t ring_get_used(ring_t *ring) {
+	return (uint32_t)(atomic_load_explicit(&ring->head, memory_order_acquire) - atomic_load_explicit(&ring->tail, memory_order_relaxed));
 }
 
-// Writes given data to buffer.
-// Returns CBUFFER_SUCCESS or CBUFFER_NOMEM if out of memory.
-static inline int cbuffer_enqueue(cbuffer_t *buf, const void *data, int data_size) {
-	int free = cbuffer_get_free(buf);
+// Producer: writes one row.
+// Returns RING_SUCCESS or RING_NOMEM if the ring is full.
+static inline int ring_push(ring_t *ring, const float *row) {
+	const uint_fast32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
 
 	// Out of memory?
-	if (free < data_size)
-		return CBUFFER_NOMEM;
+	if ((uint32_t)(head - atomic_load_explicit(&ring->tail, memory_order_acquire)) > ring->mask)
+		return RING_NOMEM;
 
-	// Is the data split in the end?
-	if (buf->write + data_size > buf->size) {
-		int first_size = buf->size - buf->write;
-		memcpy(buf->buf + buf->write, data, first_size);
-		memcpy(buf->buf, ((char *)data) + first_size, data_size - first_size);
-	}
-	else {
-		memcpy(buf->buf + buf->write, data, data_size);
-	}
-	buf->write += data_size;
-	if (buf->write >= buf->size)
-		buf->write -= buf->size;
+	const uint32_t index = (uint32_t)head & ring->mask;
+	memcpy(ring->buf + index * ring->row_size, row, ring->row_size * sizeof(float));
+	if (index < ring->mirror)
+		memcpy(ring->buf + (index + ring->mask + 1) * ring->row_size, row, ring->row_size * sizeof(float));
 
-	buf->used += data_size;
-	return CBUFFER_SUCCESS;
+	// Publish the row
+	atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+	return RING_SUCCESS;
 }
 
-// Advances the read pointer by given count.
-// Returns CBUFFER_SUCCESS on success or CBUFFER_NOMEM if count is more than available data
-static inline int cbuffer_advance(cbuffer_t *buf, int count) {
-	int used = cbuffer_get_used(buf);
-
-	if (count > used)
-		return CBUFFER_NOMEM;
-
-	buf->read += count;
-	if (buf->read >= buf->size)
-		buf->read -= buf->size;
-
-	// Reset pointers to 0 if buffer is empty in order to avoid unwanted wrapps.
-	if (buf->read == buf->write) {
-		buf->read = 0;
-		buf->write = 0;
-	}
-
-	buf->used -= count;
-	return CBUFFER_SUCCESS;
+// Consumer: pointer to the oldest row, the following rows (up to mirror + 1 rows) are contiguous.
+// The rows stay valid until they are released with ring_advance.
+static inline const float* ring_readptr(ring_t *ring) {
+	const uint32_t index = (uint32_t)atomic_load_explicit(&ring->tail, memory_order_relaxed) & ring->mask;
+	return ring->buf + index * ring->row_size;
 }
 
-// Returns a read pointer at given offset and  
-// updates *can_read_bytes (if not NULL) with the number of bytes that can be read.
-// 
-// Note! Byte count written to can_read_bytes can be less than what cbuffer_get_used() returns.
-// This happens when the read has to be split in two since it's a circular buffer.
-static inline void* cbuffer_readptr(cbuffer_t* buf, int offset, int* can_read_bytes)
-{
-	int a0 = buf->read + offset;
-	if (a0 >= buf->size)
-		a0 -= buf->size;
-	if (can_read_bytes != NULL)
-	{
-		int c0 = buf->used;
-		if (a0 + c0 > buf->size)
-			c0 = buf->size - a0;
+// Consumer: releases "count" rows to the producer.
+// Returns RING_SUCCESS on success or RING_NOMEM if count is more than available rows
+static inline int ring_advance(ring_t *ring, uint32_t count) {
+	if (count > ring_get_used(ring))
+		return RING_NOMEM;
 
-		*can_read_bytes = c0;
-	}
-	return buf->buf + a0;
+	atomic_fetch_add_explicit(&ring->tail, count, memory_order_release);
+	return RING_SUCCESS;
 }
 
-// Copies given "count" bytes to the "dst" buffer without advancing the buffer read offset.
-// Returns CBUFFER_SUCCESS on success or CBUFFER_NOMEM if count is more than available data.
-static inline int cbuffer_copyto(cbuffer_t *buf, void *dst, int count, int offset) {
-	
-	if (count > cbuffer_get_used(buf))
-		return CBUFFER_NOMEM;
-
-	int can_read_bytes;
-	void* src_ptr = cbuffer_readptr(buf, offset, &can_read_bytes);
-
-	int c0 = (count < can_read_bytes) ? count : can_read_bytes;
-	memcpy(dst, src_ptr, c0);
-	
-	int c1 = count - c0;
-
-	if (c1 > 0)
-		memcpy(((char *)dst) + c0, buf->buf, c1);
-
-	return CBUFFER_SUCCESS;
+// Consumer: releases all the rows written so far (the producer can keep on writing).
+static inline void ring_discard(ring_t *ring) {
+	atomic_store_explicit(&ring->tail, atomic_load_explicit(&ring->head, memory_order_acquire), memory_order_release);
 }
 
 typedef struct {
-	cbuffer_t data_buffer;			// Circular Buffer for features
+	ring_t data_buffer;				// Ring of features (one row per input)
 	int input_size;					// Number of bytes in each input chunk
 } fixwin_t;
 
@@ -5020,28 +4984,50 @@ static_assert(sizeof(fixwin_t) <= 64, "Data structure 'fixwin_t' is too big");
 * Try to dequeue a window.
 *
 * @param handle Pointer to an initialized handle.
-* @param dst Pointer where to write window.
-* @param stride_count Number of items (of size handle->input_size) to stride window.
+* @param window Set to the window, contiguous inside of the ring (no copy). Valid until fixwin_release.
+* @param count Number of items (of size handle->input_size) in the window.
 * @return IPWIN_RET_SUCCESS (0) or IPWIN_RET_NODATA (-1) is no data is available.
 */
-static inline int fixwin_dequeue(void* restrict handle, void* restrict dst, int count, int stride_count)
+static inline int fixwin_dequeue(void* restrict handle, const void** window, int count)
 {
 	fixwin_t* fep = (fixwin_t*)handle;
 
-	const int stride_bytes = stride_count * fep->input_size;
-	const int size = count * fep->input_size;
-	if (cbuffer_get_used(&fep->data_buffer) >= size) {
-		if (cbuffer_copyto(&fep->data_buffer, dst, size, 0) != 0)
-			return IPWIN_RET_ERROR;
-
-		if (cbuffer_advance(&fep->data_buffer, stride_bytes) != 0)
-			return IPWIN_RET_ERROR;
-
+	if (ring_get_used(&fep->data_buffer) >= (uint32_t)count) {
+		*window = ring_readptr(&fep->data_buffer);
 		return IPWIN_RET_SUCCESS;
 	}
 	return IPWIN_RET_NODATA;
 }
 
+/*
+* Release the beginning of the window returned by fixwin_dequeue (once processed).
+*
+* @param handle Pointer to an initialized handle.
+* @param stride_count Number of items (of size handle->input_size) to stride window.
+* @return IPWIN_RET_SUCCESS (0) or IPWIN_RET_ERROR (-2).
+*/
+static inline int fixwin_release(void* restrict handle, int stride_count)
+{
+	fixwin_t* fep = (fixwin_t*)handle;
+
+	if (ring_advance(&fep->data_buffer, (uint32_t)stride_count) != 0)
+		return IPWIN_RET_ERROR;
+
+	return IPWIN_RET_SUCCESS;
+}
+
+/*
+* Drop the items enqueued so far, the next window only contains items enqueued after this call.
+*
+* @param handle Pointer to an initialized handle.
+*/
+static inline void fixwin_reset(void* restrict handle)
+{
+	fixwin_t* fep = (fixwin_t*)handle;
+
+	ring_discard(&fep->data_buffer);
+}
+
 static inline void mtb_model_f32(const void* handle, const float* restrict src, int src_count, float* restrict dst, int dst_count)
 {
 	mtb_ml_model_t* model = *(mtb_ml_model_t**)handle;
@@ -5060,12 +5046,41 @@ static inline int fixwin_enqueue(void* restrict handle, const void* restrict dat
 {
 	fixwin_t* fep = (fixwin_t*)handle;
 
-	if (cbuffer_enqueue(&fep->data_buffer, data, fep->input_size) != 0)
+	if (ring_push(&fep->data_buffer, (const float*)data) != 0)
 		return IPWIN_RET_ERROR;
 
 	return IPWIN_RET_SUCCESS;
 }
 
+static uint32_t _rnn_windows = 0;
+
+/*
+* Clear the state of the recurrent layers.
+*
+* @param handle Pointer to an initialized handle.
+*/
+static inline void mtb_model_reset(const void* handle)
+{
+	mtb_ml_model_t* model = *(mtb_ml_model_t**)handle;
+	mtb_ml_model_rnn_reset_all_parameters(model);
+	_rnn_windows = 0;
+}
+
+/*
+* Clear the state of the recurrent layers every IMAI_RNN_RESYNC_WINDOWS windows (call before each run).
+*
+* @param handle Pointer to an initialized handle.
+*/
+static inline void mtb_model_resync(const void* handle)
+{
+#if IMAI_RNN_RESYNC_WINDOWS > 0
+	if (_rnn_windows == 0)
+		mtb_model_reset(handle);
+	if (++_rnn_windows >= IMAI_RNN_RESYNC_WINDOWS)
+		_rnn_windows = 0;
+#endif
+}
+
 static inline void mtb_model_free(const void* handle)
 {
 	mtb_ml_model_t* model = *(mtb_ml_model_t**)handle;
@@ -5078,9 +5093,9 @@ static inline void mtb_model_free(const void* handle)
 /**
 * Initializes a fixwin sampler handle.
 *
-* @param handle Pointer to a preallocated memory area of fixwin_handle_size() bytes to initialize.
+* @param handle Pointer to a preallocated memory area of sizeof(fixwin_t) + (ring_capacity(count) + count - 1) * input_size bytes to initialize.
 *
-* @param input_size Number of bytes to enqueue.
+* @param input_size Number of bytes to enqueue (floats).
 * @param count Number of items (of size input_size) in each window
 */
 static inline void fixwin_init(void* restrict handle, int input_size, int count)
@@ -5088,11 +5103,9 @@ static inline void fixwin_init(void* restrict handle, int input_size, int count)
 	fixwin_t* fep = (fixwin_t*)handle;
 	fep->input_size = input_size;
 
-	char* mem = ((char*)handle) + sizeof(fixwin_t);
+	float* mem = (float*)(((char*)handle) + sizeof(fixwin_t));
 
-	int data_buffer = input_size * count;
-	
-	cbuffer_init(&fep->data_buffer, mem, data_buffer);
+	ring_init(&fep->data_buffer, mem, input_size / sizeof(float), ring_capacity(count), count - 1);
 }
 
 int32_t IMAI_mtb_models_count = 0;
@@ -5174,12 +5187,15 @@ void IMAI_mtb_models_profile_log() {
 *  @return IPWIN_RET_SUCCESS (0) or IPWIN_RET_NODATA (-1), IPWIN_RET_ERROR (-2), IPWIN_RET_STREAMEND (-3)
 */
 int IMAI_dequeue(float *restrict data_out) {    
+    const void* window;
     __HOOK_REGION(true, 0);
-    __RETURN_ERROR(fixwin_dequeue(_K2, _K1, 33, 3));
+    __RETURN_ERROR(fixwin_dequeue(_K2, &window, 33));
     __HOOK_REGION(false, 0);
     __HOOK_REGION(true, 1);
-    mtb_model_f32(_K7, _K1, 99, data_out, 4);
+    mtb_model_resync(_K7);
+    mtb_model_f32(_K7, (const float*)window, 99, data_out, 4);
     __HOOK_REGION(false, 1);
+    __RETURN_ERROR(fixwin_release(_K2, 3));
     return 0;
 }
 
@@ -5196,6 +5212,15 @@ int IMAI_enqueue(const float *restrict data_in) {
     return 0;
 }
 
+/*
+* Drops the data enqueued so far and the LSTM state (e.g. after a gap in the input stream).
+* 
+*/
+void IMAI_reset(void) {    
+    fixwin_reset(_K2);
+    mtb_model_reset(_K7);
+}
+
 /*
 * Closes and flushes streams, free any heap allocated memory.
 * 
@@ -5212,6 +5237,7 @@ void IMAI_finalize(void) {
 int IMAI_init(void) {    
     fixwin_init(_K2, 12, 33);
     __RETURN_ERROR(mtb_init(_K7, _K4, 151776, _K3, 16384, 3, "network"));
+    _rnn_windows = 0;
     return 0;
 }
 
@@ -5223,18 +5249,18 @@ static IMAI_api_def _IMAI_api_def = {
     api_type: IMAI_API_TYPE_QUEUE,
     prefix: "IMAI_",
     buffer_mem: {
-        size: 396,
-        peak_usage: 396,
+        size: 0,
+        peak_usage: 0,
     },
     static_mem: {
-        size: 17008,
-        peak_usage: 16996,
+        size: 17616,
+        peak_usage: 17608,
     },
     readonly_mem: {
         size: 151776,
         peak_usage: 151776,
     },
-    func_count: 4,
+    func_count: 5,
     func_list: (IMAI_func_def[]) {
         {
             name: "IMAI_dequeue",
@@ -5289,6 +5315,15 @@ static IMAI_api_def _IMAI_api_def = {
                 },
             },
         },
+        {
+            name: "IMAI_reset",
+            description: "Drops the data enqueued so far and the LSTM state (e.g. after a gap in the input stream).",
+            fn_ptr: IMAI_reset,
+            attrib: 2,
+            param_count: 0,
+            param_list: (IMAI_param_def[]) {
+            },
+        },
         {
             name: "IMAI_finalize",
             description: "Closes and flushes streams, free any heap allocated memory.",
@@ -0,0 +1,77 @@
+/*
+ * mti.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ * Rutronik Elektronische Bauelemente GmbH Disclaimer: The evaluation board
+ * including the software is for testing purposes only and,
+ * because it has limited functions and limited resilience, is not suitable
+ * for permanent use under real conditions. If the evaluation board is
+ * nevertheless used under real conditions, this is done at one’s responsibility;
+ * any liability of Rutronik is insofar excluded
+ */
+
+#include "mti.h"
+
+int32_t mti_do(cfloat32_t* range,
+		cfloat32_t* background,
+		float32_t alpha,
+		bool initialize,
+		uint8_t antenna_count,
+		uint8_t antenna_mask,
+		uint16_t range_fft_len,
+		uint16_t num_chirps,
+		range_fft_layout_t layout)
+{
+    if ((range == NULL) || (background == NULL)) return -1;
+    if ((num_chirps == 0) || (alpha <= 0) || (alpha > 1.f)) return IFX_SENSOR_DSP_ARGUMENT_ERROR;
+
+    const bool bin_major = (layout == RANGE_FFT_LAYOUT_BIN_MAJOR);
+    const uint32_t chirp_stride = bin_major ? 1U : range_fft_len;
+    const uint32_t bin_stride = bin_major ? num_chirps : 1U;
+    const float32_t scale = 1.f / (float32_t)num_chirps;
+
+    for (uint8_t antenna_idx = 0; antenna_idx < antenna_count; ++antenna_idx)
+    {
+    	if (((1 << antenna_idx) & antenna_mask) == 0) continue;
+
+    	float32_t* cube = (float32_t*)&range[(uint32_t)antenna_idx * num_chirps * range_fft_len];
+    	float32_t* profile = (float32_t*)&background[(uint32_t)antenna_idx * range_fft_len];
+
+    	for (uint16_t bin_idx = 0; bin_idx < range_fft_len; ++bin_idx)
+    	{
+    		float32_t* values = &cube[2U * bin_idx * bin_stride];
+
+    		// Profile of the frame
+    		float32_t sum_real = 0;
+    		float32_t sum_imag = 0;
+    		for (uint16_t chirp_idx = 0; chirp_idx < num_chirps; ++chirp_idx)
+    		{
+    			sum_real += values[2U * chirp_idx * chirp_stride];
+    			sum_imag += values[2U * chirp_idx * chirp_stride + 1U];
+    		}
+    		const float32_t mean_real = sum_real * scale;
+    		const float32_t mean_imag = sum_imag * scale;
+
+    		if (initialize)
+    		{
+    			profile[2 * bin_idx] = mean_real;
+    			profile[2 * bin_idx + 1] = mean_imag;
+    		}
+
+    		// Remove the background, then update it
+    		const float32_t background_real = profile[2 * bin_idx];
+    		const float32_t background_imag = profile[2 * bin_idx + 1];
+    		for (uint16_t chirp_idx = 0; chirp_idx < num_chirps; ++chirp_idx)
+    		{
+    			values[2U * chirp_idx * chirp_stride] -= background_real;
+    			values[2U * chirp_idx * chirp_stride + 1U] -= background_imag;
+    		}
+
+    		profile[2 * bin_idx] += alpha * (mean_real - background_real);
+    		profile[2 * bin_idx + 1] += alpha * (mean_imag - background_imag);
+    	}
+    }
+
+    return IFX_SENSOR_DSP_STATUS_OK;
+}
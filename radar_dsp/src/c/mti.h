@@ -0,0 +1,53 @@
+/*
+ * mti.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ * Moving target indication: removal of the static background of the range cube across frames
+ *
+ * Rutronik Elektronische Bauelemente GmbH Disclaimer: The evaluation board
+ * including the software is for testing purposes only and,
+ * because it has limited functions and limited resilience, is not suitable
+ * for permanent use under real conditions. If the evaluation board is
+ * nevertheless used under real conditions, this is done at one’s responsibility;
+ * any liability of Rutronik is insofar excluded
+ */
+
+#ifndef MTI_H_
+#define MTI_H_
+
+#include "ifx_sensor_dsp.h"
+#include "range_fft.h"
+
+/**
+ * @brief Subtract the background range profile from the range cube (in place) and update it
+ *
+ * For each antenna of the mask and each bin, the profile of the frame is the mean of the range values over the chirps.
+ * The background (exponential average of the profiles of the previous frames) is subtracted from every chirp,
+ * then updated: background += alpha * (profile - background).
+ * Static reflectors are removed, a reflector that appeared recently is kept (also at 0 m/s) until it is part of the background.
+ *
+ * @param [in,out] range	Range cube (see range_fft_gated_do), only the bins of the range gate
+ * @param [in,out] background	Background of each antenna of the cube, background[antenna_index * range_fft_len + bin_index]
+ * @param [in] alpha	Update factor of the background, ]0, 1] (time constant is about 1 / alpha frames)
+ * @param [in] initialize	The background is set to the profile of this frame before the subtraction (first frame)
+ * @param [in] antenna_count	Number of antennas contained in range
+ * @param [in] antenna_mask		Mask used to specify which antenna should be processed
+ * @param [in] range_fft_len	Number of bins per chirp contained in range
+ * @param [in] num_chirps	Number of chirps per frame
+ * @param [in] layout	Layout of the range cube
+ *
+ * @retval 0 	Success
+ * @retval != 0	Error occurred
+ */
+int32_t mti_do(cfloat32_t* range,
+		cfloat32_t* background,
+		float32_t alpha,
+		bool initialize,
+		uint8_t antenna_count,
+		uint8_t antenna_mask,
+		uint16_t range_fft_len,
+		uint16_t num_chirps,
+		range_fft_layout_t layout);
+
+#endif /* MTI_H_ */
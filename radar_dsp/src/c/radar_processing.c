@@ -8,107 +8,532 @@
 #include "radar_processing.h"
 #include "range_fft.h"
 #include "doppler_fft.h"
+#include "mti.h"
 #include "radar_processing_internal.h"
 
-#include <stdlib.h>
+#include <string.h>
 
 #undef DEBUG_RANGE_AZIMUTH
 #define DEBUG_DATASET
 
+// If defined, the range cube is stored bin major (chirps of one bin contiguous, see range_fft_layout_t)
+// and the float map is computed in place. Faster on the host, not enabled until the gain is measured on the target
+// (see RADAR_PROCESSING_MEASURE_CYCLES in main_radar_initialization.c)
+#undef RANGE_CUBE_BIN_MAJOR
+
+// If defined, RX2 and RX3 are only evaluated at the (range, velocity) cell detected on RX1 (see range_fft_bin_do and doppler_fft_cell_do)
+// instead of computing their range FFT for every chirp. Only RX1 is then stored in the range cube
+#define RADAR_PROCESSING_LAZY_RX
+
+// If defined, the range FFT of two antennas is computed using one complex FFT (see range_fft_paired_do). Slower than the gated FFT
+// on most of the hosts measured (make bench_range), not enabled until the gain is measured on the target
+// Only useful when several antennas are in the range cube (RADAR_PROCESSING_LAZY_RX not defined)
+#undef RANGE_FFT_PAIRED
+
+#if defined(RANGE_FFT_PAIRED) && defined(RADAR_PROCESSING_LAZY_RX)
+#error "RANGE_FFT_PAIRED needs all the antennas in the range cube (RADAR_PROCESSING_LAZY_RX not defined)"
+#endif
+
+#ifdef RADAR_PROCESSING_LAZY_RX
+#define RANGE_FFT_ANTENNA_MASK 1	// antenna mask, 0b001 -> RX1
+#else
+#define RANGE_FFT_ANTENNA_MASK 7	// antenna mask, 0b111 -> RX1, RX2 and RX3
+#endif
+
+#ifdef RANGE_CUBE_BIN_MAJOR
+#define RANGE_CUBE_LAYOUT RANGE_FFT_LAYOUT_BIN_MAJOR
+#else
+#define RANGE_CUBE_LAYOUT RANGE_FFT_LAYOUT_CHIRP_MAJOR
+#endif
+
+// ROI tracking: gains of the alpha-beta filter following the peak bin
+#define RADAR_PROCESSING_ROI_ALPHA 0.5f
+#define RADAR_PROCESSING_ROI_BETA 0.1f
+
+// Motion gate: one sample every RADAR_PROCESSING_MOTION_DECIMATION of the frame is compared with the last processed frame
+// (power of 2, not a multiple of the antenna count: all the antennas and sample indexes are covered)
+#define RADAR_PROCESSING_MOTION_DECIMATION 16
+
 #if defined(DEBUG_RANGE_AZIMUTH) || defined(DEBUG_DATASET)
 #include <stdio.h>
 #endif
 
 /**
- * @var adc_samples
- * Store the converted ADC samples.
- * This buffer is used as source for the range FFT (since the raw frame_samples contains interleaved samples).
+ * Marks an initialized instance (cleared by radar_processing_deinit)
  */
-static float* adc_samples = NULL;
+#define RADAR_PROCESSING_MAGIC 0x52414430U
 
 /**
- * @var window
- * Window used to be applied on the time signal before computing real FFT
+ * @brief Compute the range gate [bin_start, bin_end[ from the configuration
+ *
+ * Total range, or range gate if range_min / range_max are configured
  */
-static float* window = NULL;
+static void compute_range_gate(const radar_configuration_t* radar_configuration, uint16_t* bin_start_out, uint16_t* bin_end_out)
+{
+	const uint16_t fft_len = radar_configuration->samples_per_chirp / 2;
+	*bin_start_out = 0;
+	*bin_end_out = fft_len;
 
-/**
- * @var doppler_window
- * Window used to be applied on the range FFT signal before computing doppler FFT
- */
-static float* doppler_window = NULL;
+	if ((radar_configuration->range_max > radar_configuration->range_min) && (radar_configuration->end_freq > radar_configuration->start_freq))
+	{
+		// One bin of the range FFT is c / (2 * bandwidth) meters
+		const float bin_length = 299792458.f / (2.f * (float)(radar_configuration->end_freq - radar_configuration->start_freq));
+		uint32_t bin_start = (uint32_t)(radar_configuration->range_min / bin_length);
+		uint32_t bin_end = (uint32_t)ceilf(radar_configuration->range_max / bin_length) + 1;
+		if (bin_end > fft_len) bin_end = fft_len;
+		if (bin_start < bin_end)
+		{
+			*bin_start_out = bin_start;
+			*bin_end_out = bin_end;
+		}
+	}
+}
 
 /**
- * @var range
- * Store the output of the range computation
- * Allocated once at start
- * Size is antenna count * chirps per frame * (samples per chirp / 2) * sizeof(cfloat)
- * Why samples per chirp / 2 and not (samples per chirp) / 2 + 1 -> because of the implementation of the FFT
+ * @brief Reserve size bytes (aligned on RADAR_PROCESSING_MEMORY_ALIGNMENT) at *offset
+ *
+ * @retval Pointer to the reserved block, NULL if base is NULL (size computation only)
  */
-static cfloat32_t* range = NULL;
+static void* memory_reserve(uint8_t* base, size_t* offset, size_t size)
+{
+	void* block = (base != NULL) ? (void*)(base + *offset) : NULL;
+	*offset += (size + RADAR_PROCESSING_MEMORY_ALIGNMENT - 1) & ~((size_t)RADAR_PROCESSING_MEMORY_ALIGNMENT - 1);
+	return block;
+}
 
 /**
- * @var doppler_out
- * Store the result of the doppler FFT for one bin
- * doppler_out is the output of the FFT of complex values
+ * @brief Memory layout of an instance
+ *
+ * Used by radar_processing_memory_requirement (handle NULL, only the size is computed)
+ * and by radar_processing_init (buffers of handle assigned inside of base), so both always agree.
+ *
+ * @retval Number of bytes used
  */
-static cfloat32_t* doppler_out = NULL;
+static size_t memory_layout(const radar_configuration_t* radar_configuration, uint8_t* base, radar_processing_t* handle)
+{
+	uint16_t bin_start = 0;
+	uint16_t bin_end = 0;
+	compute_range_gate(radar_configuration, &bin_start, &bin_end);
 
-static radar_processing_internal_param_t internal_params;
+	const size_t bin_count = bin_end - bin_start;
+	const size_t chirps = radar_configuration->chirps_per_frame;
+	const size_t samples = radar_configuration->samples_per_chirp;
+	const bool fixed_point = (radar_configuration->arithmetic == RADAR_PROCESSING_FIXED_POINT);
 
+#ifdef RADAR_PROCESSING_LAZY_RX
+	const size_t range_antenna_count = 1;
+#else
+	const size_t range_antenna_count = radar_configuration->antenna_count;
+#endif
+
+	radar_processing_t layout = { 0 };
+	size_t offset = 0;
+
+	memory_reserve(base, &offset, sizeof(radar_processing_t));
+
+	if (fixed_point)
+	{
+		layout.range_q15 = memory_reserve(base, &offset, range_antenna_count * chirps * bin_count * 2 * sizeof(q15_t));
+		layout.range_exponent = memory_reserve(base, &offset, range_antenna_count * chirps * sizeof(int8_t));
+		layout.work_q15 = memory_reserve(base, &offset, 3 * samples * sizeof(q15_t));
+		layout.work_q31 = memory_reserve(base, &offset, 2 * chirps * sizeof(q31_t));
+		layout.window_q15 = memory_reserve(base, &offset, samples * sizeof(q15_t));
+		layout.doppler_window_q31 = memory_reserve(base, &offset, chirps * sizeof(q31_t));
+#ifdef RADAR_PROCESSING_LAZY_RX
+		// Time buffer of range_fft_bin_do
+		layout.adc_samples = memory_reserve(base, &offset, 2 * samples * sizeof(float));
+#endif
+	}
+	else
+	{
+		layout.adc_samples = memory_reserve(base, &offset, 2 * samples * sizeof(float));
+		layout.range = memory_reserve(base, &offset, range_antenna_count * chirps * bin_count * sizeof(cfloat32_t));
+	}
+
+#ifdef RANGE_CUBE_BIN_MAJOR
+	// RX1 part of the range cube already has the layout of the map -> Doppler FFT in place
+	if (!fixed_point)
+	{
+		layout.doppler_map = layout.range;
+	}
+	else
+#endif
+	if (!fixed_point || radar_configuration->keep_doppler_map || (radar_configuration->detection == RADAR_PROCESSING_DETECTION_CFAR))
+	{
+		layout.doppler_map = memory_reserve(base, &offset, chirps * bin_count * sizeof(cfloat32_t));
+	}
+
+	layout.doppler_out = memory_reserve(base, &offset, chirps * sizeof(cfloat32_t));
+
+	// Windows (the float versions are used to generate the fixed point tables)
+	layout.window = memory_reserve(base, &offset, samples * sizeof(float));
+	layout.doppler_window = memory_reserve(base, &offset, chirps * sizeof(float));
+
+	if ((radar_configuration->mti_alpha > 0) && !fixed_point)
+	{
+		const size_t antenna_count = radar_configuration->antenna_count;
+		layout.background = memory_reserve(base, &offset, antenna_count * bin_count * sizeof(cfloat32_t));
+#ifdef RADAR_PROCESSING_LAZY_RX
+		if (antenna_count > 1)
+		{
+			layout.background_frame = memory_reserve(base, &offset, (antenna_count - 1) * bin_count * sizeof(cfloat32_t));
+		}
+#endif
+	}
 
-int radar_processing_init(radar_configuration_t radar_configuration)
+	if (radar_configuration->motion_threshold > 0)
+	{
+		const size_t frame_len = radar_configuration->antenna_count * chirps * samples;
+		layout.motion_reference = memory_reserve(base, &offset, (frame_len / RADAR_PROCESSING_MOTION_DECIMATION) * sizeof(uint16_t));
+	}
+
+	if (radar_configuration->detection == RADAR_PROCESSING_DETECTION_THRESHOLD)
+	{
+		if (radar_configuration->prescreen_factor > 0)
+		{
+			layout.bin_energy = memory_reserve(base, &offset, 2 * bin_count * sizeof(float32_t));
+		}
+		if ((radar_configuration->prescreen_factor > 0) || (radar_configuration->roi_half_width > 0))
+		{
+			layout.bin_enabled = memory_reserve(base, &offset, bin_count * sizeof(bool));
+		}
+	}
+
+	if (radar_configuration->detection == RADAR_PROCESSING_DETECTION_CFAR)
+	{
+		layout.power = memory_reserve(base, &offset, chirps * bin_count * sizeof(float32_t));
+		layout.cfar_work = memory_reserve(base, &offset, cfar_work_len(&radar_configuration->cfar, chirps) * sizeof(float32_t));
+	}
+
+	if (handle != NULL)
+	{
+		handle->params.bin_start = bin_start;
+		handle->params.bin_end = bin_end;
+		handle->adc_samples = layout.adc_samples;
+		handle->range = layout.range;
+		handle->doppler_map = layout.doppler_map;
+		handle->doppler_out = layout.doppler_out;
+		handle->window = layout.window;
+		handle->doppler_window = layout.doppler_window;
+		handle->range_q15 = layout.range_q15;
+		handle->range_exponent = layout.range_exponent;
+		handle->work_q15 = layout.work_q15;
+		handle->work_q31 = layout.work_q31;
+		handle->window_q15 = layout.window_q15;
+		handle->doppler_window_q31 = layout.doppler_window_q31;
+		handle->background = layout.background;
+		handle->background_frame = layout.background_frame;
+		handle->motion_reference = layout.motion_reference;
+		handle->bin_energy = layout.bin_energy;
+		handle->bin_enabled = layout.bin_enabled;
+		handle->power = layout.power;
+		handle->cfar_work = layout.cfar_work;
+	}
+
+	return offset;
+}
+
+size_t radar_processing_memory_requirement(const radar_configuration_t* radar_configuration)
 {
-	// Save
-	internal_params.antenna_count = radar_configuration.antenna_count;
-	internal_params.chirps_per_frame = radar_configuration.chirps_per_frame;
-	internal_params.samples_per_chirp = radar_configuration.samples_per_chirp;
-	internal_params.sampling_rate = radar_configuration.sampling_rate;
-	internal_params.start_freq = radar_configuration.start_freq;
-	internal_params.end_freq = radar_configuration.end_freq;
+	if (radar_configuration == NULL) return 0;
+
+	return memory_layout(radar_configuration, NULL, NULL);
+}
+
+int radar_processing_init(radar_processing_t** handle, const radar_configuration_t* radar_configuration, void* memory, size_t memory_size)
+{
+	if ((handle == NULL) || (radar_configuration == NULL) || (memory == NULL)) return -1;
+	*handle = NULL;
+
+	if (((uintptr_t)memory % RADAR_PROCESSING_MEMORY_ALIGNMENT) != 0) return -2;
+	if (memory_size < radar_processing_memory_requirement(radar_configuration)) return -5;
+	if ((radar_configuration->detection == RADAR_PROCESSING_DETECTION_CFAR)
+			&& (cfar_config_check(&radar_configuration->cfar, radar_configuration->chirps_per_frame) != 0)) return -6;
+	if ((radar_configuration->mti_alpha < 0) || (radar_configuration->mti_alpha > 1.f)) return -1;
+	if ((radar_configuration->prescreen_factor < 0) || (radar_configuration->motion_threshold < 0)) return -1;
+	if ((radar_configuration->mti_alpha > 0) && (radar_configuration->arithmetic == RADAR_PROCESSING_FIXED_POINT)) return -7;
+	if (radar_configuration->antenna_count < RADAR_PROCESSING_MIN_ANTENNAS) return -8;
+
+	radar_processing_t* processing = (radar_processing_t*) memory;
+	memset(processing, 0, sizeof(radar_processing_t));
 
-	// internal_params.threshold = 0.1;
-	internal_params.threshold = 0.05;
+	// Place the buffers (and compute bin_start / bin_end)
+	memory_layout(radar_configuration, (uint8_t*)memory, processing);
 
-	// Compute bin_start and bin_end
-	// Total range
-	const uint16_t fft_len = internal_params.samples_per_chirp / 2;
-	internal_params.bin_start = 0;
-	internal_params.bin_end = fft_len;
+	// Save
+	radar_processing_internal_param_t* params = &processing->params;
+	params->antenna_count = radar_configuration->antenna_count;
+	params->chirps_per_frame = radar_configuration->chirps_per_frame;
+	params->samples_per_chirp = radar_configuration->samples_per_chirp;
+	params->sampling_rate = radar_configuration->sampling_rate;
+	params->start_freq = radar_configuration->start_freq;
+	params->end_freq = radar_configuration->end_freq;
+	params->arithmetic = radar_configuration->arithmetic;
+	params->detection = radar_configuration->detection;
+	params->cfar = radar_configuration->cfar;
+	params->mti_alpha = radar_configuration->mti_alpha;
+	params->prescreen_factor = radar_configuration->prescreen_factor;
+	params->motion_threshold = radar_configuration->motion_threshold;
+	params->roi_half_width = radar_configuration->roi_half_width;
+	params->roi_full_scan_period = radar_configuration->roi_full_scan_period;
+	processing->roi_start = 0;
+	processing->roi_end = params->bin_end - params->bin_start;
 
-	// Allocate
-	adc_samples = (float*) malloc(radar_configuration.samples_per_chirp * sizeof(float));
-	if (adc_samples == NULL) return -5;
+	// params->threshold = 0.1;
+	params->threshold = 0.05;
 
-	range = (cfloat32_t*) malloc(radar_configuration.antenna_count * radar_configuration.chirps_per_frame * (radar_configuration.samples_per_chirp / 2) * sizeof(cfloat32_t));
-	if (range == NULL) return -6;
+	// FFT contexts
+	if (range_fft_ctx_init(&processing->range_ctx, params->samples_per_chirp, params->bin_start, params->bin_end, RANGE_CUBE_LAYOUT) != 0) return -3;
+	if (doppler_fft_ctx_init(&processing->doppler_ctx, params->chirps_per_frame, RANGE_CUBE_LAYOUT) != 0) return -4;
 
-	doppler_out = (cfloat32_t*) malloc(radar_configuration.chirps_per_frame * sizeof(cfloat32_t));
-	if (range == NULL) return -7;
+	const bool fixed_point = (params->arithmetic == RADAR_PROCESSING_FIXED_POINT);
 
 	// Generate window
-	window = (float*) malloc(radar_configuration.samples_per_chirp * sizeof(float));
-	if (window == NULL) return -8;
-	ifx_window_blackmanharris_f32(window, radar_configuration.samples_per_chirp);
+	ifx_window_blackmanharris_f32(processing->window, params->samples_per_chirp);
+	if (fixed_point)
+	{
+		range_fft_window_q15_init(processing->window_q15, processing->window, params->samples_per_chirp);
+	}
+	range_fft_window_init(processing->window, processing->window, params->samples_per_chirp);
 
 	// Generate doppler window (applied before computing doppler FFT)
-	doppler_window = (float*) malloc(radar_configuration.chirps_per_frame * sizeof(float));
-	if (doppler_window == NULL) return -9;
-	ifx_window_blackmanharris_f32(doppler_window, radar_configuration.chirps_per_frame);
+	ifx_window_blackmanharris_f32(processing->doppler_window, params->chirps_per_frame);
+	params->doppler_window_energy = 0;
+	for (uint16_t i = 0; i < params->chirps_per_frame; ++i)
+	{
+		params->doppler_window_energy += processing->doppler_window[i] * processing->doppler_window[i];
+	}
+	if (fixed_point)
+	{
+		doppler_fft_window_q31_init(processing->doppler_window_q31, processing->doppler_window, params->chirps_per_frame);
+	}
+
+	processing->magic = RADAR_PROCESSING_MAGIC;
+	*handle = processing;
 
 	return 0;
 }
 
-static float get_magnitude(cfloat32_t complex_value)
+void radar_processing_deinit(radar_processing_t* handle)
 {
-	float32_t* value = (float32_t*)&complex_value;
-	float32_t real = value[0];
-	float32_t imag = value[1];
-	float32_t magnitude = 0;
+	if (handle == NULL) return;
+
+	// The memory belongs to the caller, only invalidate the instance
+	handle->magic = 0;
+}
+
+#ifdef RADAR_PROCESSING_LAZY_RX
+/**
+ * @brief Compute the Doppler value of one antenna at the (bin, velocity) cell directly from the frame
+ *
+ * The range values of the bin are computed into doppler_out, then only the velocity_idx Doppler value is evaluated.
+ * Done in float for both arithmetics.
+ */
+static cfloat32_t compute_cell(radar_processing_t* handle, uint16_t* frame_samples, uint16_t bin_idx, uint16_t velocity_idx, uint8_t antenna_idx)
+{
+	const radar_processing_internal_param_t* params = &handle->params;
+	cfloat32_t cell = { 0 };
+
+	range_fft_bin_do(&handle->range_ctx,
+			frame_samples,
+			handle->doppler_out,	// Range value of the bin for each chirp
+			handle->adc_samples,
+			true,					// remove mean
+			handle->window,			// window (Blackman Harris, ADC scaling included)
+			params->antenna_count,
+			antenna_idx,
+			bin_idx,
+			params->chirps_per_frame);
+
+	// Same clutter filter as RX1 in the range cube: background subtracted (MTI) instead of the mean of the frame
+	if (handle->background != NULL)
+	{
+		const uint16_t bin_count = params->bin_end - params->bin_start;
+		const cfloat32_t background = handle->background[(uint32_t)antenna_idx * bin_count + (bin_idx - params->bin_start)];
+		for (uint16_t chirp_idx = 0; chirp_idx < params->chirps_per_frame; ++chirp_idx)
+		{
+			CREAL_F32(handle->doppler_out[chirp_idx]) -= CREAL_F32(background);
+			CIMAG_F32(handle->doppler_out[chirp_idx]) -= CIMAG_F32(background);
+		}
+	}
+
+	doppler_fft_cell_do(&handle->doppler_ctx,
+			handle->doppler_out,
+			&cell,
+			(handle->background == NULL),	// Remove mean (0 m/s speed), the background was already removed
+			handle->doppler_window,	// Window
+			velocity_idx);
 
-	arm_sqrt_f32((real * real) + (imag * imag), &magnitude);
+	return cell;
+}
+#else
+/**
+ * @brief Compute the Doppler FFT of one bin into doppler_out (float or fixed point, depending on the configuration)
+ */
+static void compute_doppler(radar_processing_t* handle, uint16_t bin_idx, uint16_t antenna_idx)
+{
+	const radar_processing_internal_param_t* params = &handle->params;
 
-	return magnitude;
+	// range only contains the bins of the range gate
+	const uint16_t bin_count = params->bin_end - params->bin_start;
+	bin_idx -= params->bin_start;
+
+	if (params->arithmetic == RADAR_PROCESSING_FIXED_POINT)
+	{
+		doppler_fft_bin_q31_do(&handle->doppler_ctx,
+				handle->range_q15,
+				handle->range_exponent,
+				handle->doppler_out,	// Doppler FFT output (size is chirps_per_frame)
+				handle->work_q31,
+				true,					// Remove mean (0 m/s speed)
+				handle->doppler_window_q31,	// Window
+				bin_idx,				// Bin index (inside the range gate)
+				antenna_idx,			// Antenna index
+				bin_count);
+		return;
+	}
+
+	doppler_fft_bin_do(&handle->doppler_ctx,
+			handle->range,
+			handle->doppler_out,	// Doppler FFT output (size is chirps_per_frame)
+			(handle->background == NULL),	// Remove mean (0 m/s speed), the MTI stage already removed the background
+			handle->doppler_window,	// Window
+			bin_idx,				// Bin index (inside the range gate)
+			antenna_idx,			// Antenna index
+			bin_count);
+}
+#endif
+
+/**
+ * @brief Select the bins of RX1 for which the Doppler FFT is computed (energy pre-screen)
+ *
+ * A bin is skipped if its energy is below prescreen_factor * noise floor (median of the energies of the frame)
+ * and if none of its Doppler values can reach the peak of the most energetic bin of the region of interest
+ * (|doppler|^2 <= sum(w^2) * energy). The peak (and therefore the output of radar_processing_feed) is never changed,
+ * the weaker local maxima may be lost: not used by radar_processing_feed_targets.
+ */
+static void compute_prescreen(radar_processing_t* handle)
+{
+	const radar_processing_internal_param_t* params = &handle->params;
+	const uint16_t bin_count = params->bin_end - params->bin_start;
+	const bool mean_removal = (handle->background == NULL);
+
+	if (params->arithmetic == RADAR_PROCESSING_FIXED_POINT)
+	{
+		doppler_fft_energy_q15(&handle->doppler_ctx, handle->range_q15, handle->range_exponent, handle->bin_energy, mean_removal, 0, bin_count);
+	}
+	else
+	{
+		doppler_fft_energy(&handle->doppler_ctx, handle->range, handle->bin_energy, mean_removal, 0, bin_count);
+	}
+
+	// Noise floor
+	float32_t* sorted = &handle->bin_energy[bin_count];
+	memcpy(sorted, handle->bin_energy, bin_count * sizeof(float32_t));
+	const float32_t limit = params->prescreen_factor * cfar_select(sorted, bin_count, bin_count / 2);
+
+	// Peak of the most energetic bin of the region of interest: lower bound of the peak
+	float32_t max_energy = 0;
+	uint32_t max_bin = 0;
+	arm_max_f32(&handle->bin_energy[handle->roi_start], handle->roi_end - handle->roi_start, &max_energy, &max_bin);
+	max_bin += handle->roi_start;
+
+	if (params->arithmetic == RADAR_PROCESSING_FIXED_POINT)
+	{
+		doppler_fft_bin_q31_do(&handle->doppler_ctx, handle->range_q15, handle->range_exponent, handle->doppler_out, handle->work_q31,
+				true, handle->doppler_window_q31, max_bin, 0, bin_count);
+	}
+	else
+	{
+		doppler_fft_bin_do(&handle->doppler_ctx, handle->range, handle->doppler_out,
+				mean_removal, handle->doppler_window, max_bin, 0, bin_count);
+	}
+
+	float32_t peak = 0;
+	for (uint16_t velocity = 0; velocity < params->chirps_per_frame; ++velocity)
+	{
+		const float32_t* value = (const float32_t*)&handle->doppler_out[velocity];
+		const float32_t power = value[0] * value[0] + value[1] * value[1];
+		if (power > peak) peak = power;
+	}
+	const float32_t peak_limit = peak / params->doppler_window_energy;
+
+	for (uint16_t bin = 0; bin < bin_count; ++bin)
+	{
+		handle->bin_enabled[bin] = (handle->bin_energy[bin] >= limit) || (handle->bin_energy[bin] >= peak_limit);
+	}
+	handle->bin_enabled[max_bin] = true;
+}
+
+/**
+ * @brief Select the bins of RX1 for which the Doppler FFT is computed (pre-screen and region of interest)
+ *
+ * @retval Bins selected, NULL -> all
+ */
+static const bool* select_bins(radar_processing_t* handle)
+{
+	const uint16_t bin_count = handle->params.bin_end - handle->params.bin_start;
+
+	const bool* bin_enabled = NULL;
+	if (handle->bin_enabled != NULL)
+	{
+		if (handle->bin_energy != NULL)
+		{
+			compute_prescreen(handle);
+			bin_enabled = handle->bin_enabled;
+		}
+		else
+		{
+			memset(handle->bin_enabled, true, bin_count * sizeof(bool));
+		}
+
+		// Region of interest
+		if ((handle->roi_end - handle->roi_start) < bin_count)
+		{
+			memset(handle->bin_enabled, false, handle->roi_start * sizeof(bool));
+			memset(&handle->bin_enabled[handle->roi_end], false, (bin_count - handle->roi_end) * sizeof(bool));
+			bin_enabled = handle->bin_enabled;
+		}
+	}
+
+	return bin_enabled;
+}
+
+/**
+ * @brief Compute the range-Doppler map of RX1 into doppler_map (float or fixed point, depending on the configuration)
+ *
+ * @param [in] bin_enabled	Bins for which the Doppler FFT is computed (see select_bins), NULL -> all
+ */
+static void compute_doppler_map(radar_processing_t* handle, const bool* bin_enabled)
+{
+	const radar_processing_internal_param_t* params = &handle->params;
+	const uint16_t bin_count = params->bin_end - params->bin_start;
+
+	if (params->arithmetic == RADAR_PROCESSING_FIXED_POINT)
+	{
+		doppler_fft_map_q31_do(&handle->doppler_ctx,
+				handle->range_q15,
+				handle->range_exponent,
+				handle->doppler_map,
+				handle->work_q31,
+				true,					// Remove mean (0 m/s speed)
+				handle->doppler_window_q31,	// Window
+				params->antenna_count,
+				1,						// Antenna mask, 0b001 -> RX1
+				bin_count,
+				bin_enabled);			// Bins selected by the pre-screen / ROI (NULL -> all)
+		return;
+	}
+
+	doppler_fft_map_do(&handle->doppler_ctx,
+			handle->range,
+			handle->doppler_map,
+			(handle->background == NULL),	// Remove mean (0 m/s speed), the MTI stage already removed the background
+			handle->doppler_window,	// Window
+			params->antenna_count,
+			1,						// Antenna mask, 0b001 -> RX1
+			bin_count,
+			bin_enabled);			// Bins selected by the pre-screen / ROI (NULL -> all)
 }
 
 static float get_phase(cfloat32_t complex_value)
@@ -120,23 +545,121 @@ static float get_phase(cfloat32_t complex_value)
 	return atan2f(imag, real);
 }
 
-static void get_max_magnitude_phase_velocity(cfloat32_t* array, uint16_t len, float* mag_out, float* phase_out, uint16_t* velocity_out)
+/**
+ * @brief Search the peak of array on the magnitude squared (see doppler_fft_peak_search),
+ * the square root and the phase are only computed for the peak
+ *
+ * @param [in] work		Work buffer of work_len floats
+ */
+static void get_max_magnitude_phase_velocity(cfloat32_t* array, uint32_t len, float32_t* work, uint32_t work_len, float* mag_out, float* phase_out, uint32_t* velocity_out)
+{
+	float32_t max_squared = 0;
+	uint32_t max_index = 0;
+	doppler_fft_peak_search(array, len, work, work_len, &max_index, &max_squared);
+
+	arm_sqrt_f32(max_squared, mag_out);
+	*phase_out = get_phase(array[max_index]);
+	*velocity_out = max_index;
+}
+
+/**
+ * @brief Fixed point without the map: Doppler FFT of RX1 bin by bin (bins of select_bins inside of the region of interest)
+ * and peak search on the fly, same peak as get_max_magnitude_phase_velocity on the map
+ *
+ * @param [out] index_out	Peak, bin (inside the range gate) * chirps per frame + velocity
+ */
+static void search_peak_q31(radar_processing_t* handle, float* mag_out, float* phase_out, uint32_t* index_out)
 {
-	float max = 0;
-	uint16_t max_index = 0;
-	for(uint16_t i = 0; i < len; ++i)
+	const radar_processing_internal_param_t* params = &handle->params;
+	const uint16_t bin_count = params->bin_end - params->bin_start;
+	const bool* bin_enabled = select_bins(handle);
+
+	// work_q31 is free once the FFT of the bin is done -> magnitude squared of the bin
+	float32_t* power = (float32_t*)handle->work_q31;
+	float32_t max_squared = 0;
+	uint32_t max_index = (uint32_t)handle->roi_start * params->chirps_per_frame;
+	cfloat32_t peak = { 0 };
+
+	for (uint16_t bin = handle->roi_start; bin < handle->roi_end; ++bin)
 	{
-		float mag = get_magnitude(array[i]);
-		if (mag > max)
+		if ((bin_enabled != NULL) && !bin_enabled[bin]) continue;
+
+		doppler_fft_bin_q31_do(&handle->doppler_ctx,
+				handle->range_q15,
+				handle->range_exponent,
+				handle->doppler_out,
+				handle->work_q31,
+				true,					// Remove mean (0 m/s speed)
+				handle->doppler_window_q31,	// Window
+				bin,
+				0,						// Antenna index 0 -> RX1
+				bin_count);
+
+		float32_t bin_max = 0;
+		uint32_t velocity = 0;
+		doppler_fft_peak_search(handle->doppler_out, params->chirps_per_frame, power, params->chirps_per_frame, &velocity, &bin_max);
+
+		// Strictly bigger -> first maximum kept
+		if (bin_max > max_squared)
 		{
-			max = mag;
-			max_index = i;
+			max_squared = bin_max;
+			max_index = (uint32_t)bin * params->chirps_per_frame + velocity;
+			peak = handle->doppler_out[velocity];
 		}
 	}
 
-	*mag_out = max;
-	*phase_out = get_phase(array[max_index]);
-	*velocity_out = max_index;
+	arm_sqrt_f32(max_squared, mag_out);
+	*phase_out = get_phase(peak);
+	*index_out = max_index;
+}
+
+/**
+ * @brief Run the CFAR detector on the map of RX1 (detections stored in the instance)
+ *
+ * The strongest detection is returned as the target of the frame, amplitude is the maximum of the map
+ * (same meaning as with the fixed threshold).
+ *
+ * @retval true if at least one cell was detected
+ */
+static bool detect_cfar(radar_processing_t* handle, float* mag_out, float* phase_out, uint32_t* index_out)
+{
+	const radar_processing_internal_param_t* params = &handle->params;
+	const uint16_t bin_count = params->bin_end - params->bin_start;
+	const uint32_t cell_count = (uint32_t)bin_count * params->chirps_per_frame;
+
+	arm_cmplx_mag_squared_f32((float32_t*)handle->doppler_map, handle->power, cell_count);
+
+	cfar_do(&params->cfar,
+			handle->power,
+			bin_count,
+			params->chirps_per_frame,
+			handle->cfar_work,
+			handle->detections,
+			RADAR_PROCESSING_MAX_DETECTIONS,
+			&handle->detection_count);
+
+	float32_t max_squared = 0;
+	uint32_t max_index = 0;
+	arm_max_f32(handle->power, cell_count, &max_squared, &max_index);
+	arm_sqrt_f32(max_squared, mag_out);
+
+	if (handle->detection_count == 0)
+	{
+		*phase_out = 0;
+		*index_out = 0;
+		return false;
+	}
+
+	*index_out = (uint32_t)handle->detections[0].bin * params->chirps_per_frame + handle->detections[0].velocity;
+	*phase_out = get_phase(handle->doppler_map[*index_out]);
+
+	// Absolute range bins for the caller
+	for (uint16_t i = 0; i < handle->detection_count; ++i)
+	{
+		handle->detections[i].bin += params->bin_start;
+	}
+
+	return true;
 }
 
 static float f32abs(float a)
@@ -160,96 +683,416 @@ static float get_angle_diff(float a1, float a2)
     return angle;
 }
 
-void radar_processing_feed(uint16_t * frame_samples, radar_processing_out_t* result)
+/**
+ * @brief Motion gate: compare the frame with the last processed frame (decimated)
+ *
+ * The reference is only updated by the processed frames, so a slow motion accumulates until it is detected.
+ *
+ * @retval true if the frame has to be processed
+ */
+static bool detect_motion(radar_processing_t* handle, const uint16_t* frame_samples)
+{
+	const radar_processing_internal_param_t* params = &handle->params;
+	const uint32_t count = ((uint32_t)params->antenna_count * params->chirps_per_frame * params->samples_per_chirp) / RADAR_PROCESSING_MOTION_DECIMATION;
+	uint16_t* reference = handle->motion_reference;
+
+	if (handle->motion_reference_valid)
+	{
+		// Stop as soon as the limit is reached
+		const uint32_t limit = (uint32_t)(params->motion_threshold * (float)count);
+		uint32_t difference = 0;
+		for (uint32_t i = 0; (i < count) && (difference <= limit); ++i)
+		{
+			const int32_t delta = (int32_t)frame_samples[i * RADAR_PROCESSING_MOTION_DECIMATION] - (int32_t)reference[i];
+			difference += (uint32_t)((delta < 0) ? -delta : delta);
+		}
+
+		if (difference <= limit) return false;
+	}
+
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		reference[i] = frame_samples[i * RADAR_PROCESSING_MOTION_DECIMATION];
+	}
+	handle->motion_reference_valid = true;
+
+	return true;
+}
+
+/**
+ * @brief Range FFT of the chirps [first_chirp, first_chirp + chirp_count[ of the frame into the range cube
+ *
+ * @param [in] chirps	Raw samples of these chirps only (chirps[0] is the first sample of first_chirp)
+ */
+static void compute_range(radar_processing_t* handle, const uint16_t* chirps, uint16_t first_chirp, uint16_t chirp_count)
 {
-	const uint16_t fft_len = internal_params.samples_per_chirp / 2;
+	const radar_processing_internal_param_t* params = &handle->params;
 
-	// Compute range FFT of the frame. For each chirp compute a FFT -> output inside "range"
-	// only compute for RX1 and RX3 (since we only consider the azimuth so far)
-	range_fft_do(frame_samples,
-			range,
-			adc_samples,
-			true,				// remove mean
-			window,				// window (Blackman Harris)
-			internal_params.antenna_count,
-			// 5,					// antenna mask, 0b101 -> RX1 and RX3 (do not compute RX2)
-			7, // antenna mask, 0b111 -> RX1, RX2 and RX3
-			internal_params.samples_per_chirp,
-			internal_params.chirps_per_frame);
+	// For each chirp compute a FFT -> output inside "range"
+	// only compute for the antennas of RANGE_FFT_ANTENNA_MASK (RX1 only with RADAR_PROCESSING_LAZY_RX)
+	if (params->arithmetic == RADAR_PROCESSING_FIXED_POINT)
+	{
+		range_fft_q15_chirps_do(&handle->range_ctx,
+				chirps,
+				handle->range_q15,
+				handle->range_exponent,
+				handle->work_q15,
+				true,				// remove mean
+				handle->window_q15,	// window (Blackman Harris)
+				params->antenna_count,
+				RANGE_FFT_ANTENNA_MASK,
+				params->chirps_per_frame,
+				first_chirp,
+				chirp_count);
+	}
+	else
+	{
+#ifdef RANGE_FFT_PAIRED
+		range_fft_paired_chirps_do(&handle->range_ctx,
+#else
+		range_fft_gated_chirps_do(&handle->range_ctx,
+#endif
+				chirps,
+				handle->range,
+				handle->adc_samples,
+				true,				// remove mean
+				handle->window,		// window (Blackman Harris, ADC scaling included)
+				params->antenna_count,
+				RANGE_FFT_ANTENNA_MASK,
+				params->chirps_per_frame,
+				first_chirp,
+				chirp_count);
+	}
+}
 
-	// Compute Doppler FFT for each bin (only for antenna 0 to save time)
-	// Bin index from [0] to [(samples per chirp / 2) - 1]
-	// and extract maximum
-	float maximum_doppler = 0;
-	uint16_t max_bin_idx = 0;
-	float phase_rx1 = 0;
-	uint16_t velocity_rx1 = 0;
-
-	for(uint16_t bin_idx = internal_params.bin_start; bin_idx < internal_params.bin_end; ++bin_idx)
-	{
-		doppler_fft_bin_do(range,
-				doppler_out,		// Doppler FFT output (size is chirps_per_frame)
-				true,				// Remove mean (0 m/s speed)
-				doppler_window,		// Window
-				bin_idx,			// Bin index
-				0, 					// Antenna index -> RX1
-				internal_params.chirps_per_frame,
-				fft_len);
-
-		// Get maximum amplitude (and phase for it)
-		float max_magnitude = 0;
-		float max_phase = 0;
-		uint16_t max_velocity = 0;
-
-		get_max_magnitude_phase_velocity(doppler_out, internal_params.chirps_per_frame, &max_magnitude, &max_phase, &max_velocity);
-		if (max_magnitude > maximum_doppler)
+#ifdef RADAR_PROCESSING_LAZY_RX
+/**
+ * @brief MTI of the antennas that are not in the range cube (RX2, RX3): range profile of the frame into background_frame
+ *
+ * @param [in] initialize	First frame -> the background is set to the profile of the frame (as mti_do)
+ */
+static void mti_lazy_profile(radar_processing_t* handle, const uint16_t* frame_samples, bool initialize)
+{
+	const radar_processing_internal_param_t* params = &handle->params;
+	const uint16_t bin_count = params->bin_end - params->bin_start;
+
+	for (uint8_t antenna_idx = 1; antenna_idx < params->antenna_count; ++antenna_idx)
+	{
+		cfloat32_t* profile = &handle->background_frame[(uint32_t)(antenna_idx - 1) * bin_count];
+
+		range_fft_profile_do(&handle->range_ctx,
+				frame_samples,
+				profile,
+				handle->adc_samples,
+				true,				// remove mean (as range_fft_bin_do in compute_cell)
+				handle->window,		// window (Blackman Harris, ADC scaling included)
+				params->antenna_count,
+				antenna_idx,
+				params->chirps_per_frame);
+
+		if (initialize)
 		{
-			maximum_doppler = max_magnitude;
-			max_bin_idx = bin_idx;
-			phase_rx1 = max_phase;
-			velocity_rx1 = max_velocity;
+			memcpy(&handle->background[(uint32_t)antenna_idx * bin_count], profile, bin_count * sizeof(cfloat32_t));
 		}
 	}
+}
 
-	result->amplitude = maximum_doppler;
+/**
+ * @brief Update the background of RX2 and RX3 with the profile of the frame, once compute_cell is done for the frame
+ *
+ * background += alpha * (profile - background), as mti_do
+ */
+static void mti_lazy_update(radar_processing_t* handle)
+{
+	const radar_processing_internal_param_t* params = &handle->params;
+	const uint32_t len = 2U * (params->antenna_count - 1U) * (params->bin_end - params->bin_start);
+
+	if (handle->background == NULL) return;
+
+	float32_t* background = (float32_t*)&handle->background[params->bin_end - params->bin_start];
+	const float32_t* profile = (const float32_t*)handle->background_frame;
+	for (uint32_t i = 0; i < len; ++i)
+	{
+		background[i] += params->mti_alpha * (profile[i] - background[i]);
+	}
+}
+#endif
+
+/**
+ * @brief Stages following the range FFT, once the range cube contains all the chirps of the frame: MTI and range-Doppler map
+ *
+ * @param [in] full_map	Doppler FFT of every bin (several targets), false -> only the bins of select_bins (pre-screen and ROI)
+ */
+static void compute_map(radar_processing_t* handle, const uint16_t* frame_samples, bool full_map)
+{
+	const radar_processing_internal_param_t* params = &handle->params;
+
+	// Static background removal (MTI)
+	if (handle->background != NULL)
+	{
+#ifdef RADAR_PROCESSING_LAZY_RX
+		mti_lazy_profile(handle, frame_samples, !handle->background_valid);
+#else
+		(void)frame_samples;
+#endif
+		mti_do(handle->range,
+				handle->background,
+				params->mti_alpha,
+				!handle->background_valid,	// First frame -> initialize the background
+				params->antenna_count,
+				RANGE_FFT_ANTENNA_MASK,
+				params->bin_end - params->bin_start,
+				params->chirps_per_frame,
+				RANGE_CUBE_LAYOUT);
+		handle->background_valid = true;
+	}
+
+	// Compute the range-Doppler map (only for antenna 0 to save time)
+	// Without the map (fixed point), the Doppler FFT is done by the peak search (see search_peak_q31)
+	if (handle->doppler_map != NULL)
+	{
+		compute_doppler_map(handle, full_map ? NULL : select_bins(handle));
+	}
+}
+
+/**
+ * @brief Compute the angles of the target detected on RX1 at (bin_idx, velocity_idx)
+ *
+ * @param [in] bin_idx	Absolute range bin, [bin_start] to [bin_end - 1]
+ * @param [in] phase_rx1	Phase of RX1 at the cell (from the map)
+ */
+static void compute_angles(radar_processing_t* handle, uint16_t* frame_samples, uint16_t bin_idx, uint16_t velocity_idx, float phase_rx1,
+		float* azimuth_out, float* elevation_out)
+{
+	// Need to compute doppler FFT (but only for range idx = bin_idx
+	// then compute the phase difference
+
+#ifdef RADAR_PROCESSING_LAZY_RX
+	float phase_rx3 = get_phase(compute_cell(handle, frame_samples, bin_idx, velocity_idx, 2));	// antenna index 2 -> RX3
+	float phase_rx2 = get_phase(compute_cell(handle, frame_samples, bin_idx, velocity_idx, 1));	// antenna index 1 -> RX2
+#else
+	(void)frame_samples;
+
+	compute_doppler(handle, bin_idx, 2);	// Bin index -> Max of RX1, antenna index 2 -> RX3
+
+	float phase_rx3 = get_phase(handle->doppler_out[velocity_idx]);
+
+	compute_doppler(handle, bin_idx, 1);	// Bin index -> Max of RX1, antenna index 1 -> RX2
+
+	float phase_rx2 = get_phase(handle->doppler_out[velocity_idx]);
+#endif
+
+	*azimuth_out = get_angle_diff(phase_rx1, phase_rx3);
+	*elevation_out = get_angle_diff(phase_rx2, phase_rx3);
+}
+
+/**
+ * @brief Search the local maxima (3x3 neighbourhood) of the map above the threshold (detections stored in the instance)
+ *
+ * Magnitude squared computed row by row, the neighbours are only evaluated for the cells above the threshold.
+ * The SNR of a detection is its power relative to the threshold.
+ */
+static void detect_peaks(radar_processing_t* handle)
+{
+	const radar_processing_internal_param_t* params = &handle->params;
+	const uint16_t bin_count = params->bin_end - params->bin_start;
+	const uint16_t velocity_count = params->chirps_per_frame;
+	const float32_t threshold_squared = params->threshold * params->threshold;
+	float32_t* power = (float32_t*)handle->doppler_out;	// Magnitude squared of one row
+
+	handle->detection_count = 0;
+
+	for (uint16_t bin = 0; bin < bin_count; ++bin)
+	{
+		arm_cmplx_mag_squared_f32((const float32_t*)&handle->doppler_map[bin * velocity_count], power, velocity_count);
+
+		for (uint16_t velocity = 0; velocity < velocity_count; ++velocity)
+		{
+			if (power[velocity] <= threshold_squared) continue;
+
+			bool maximum = true;
+			for (int32_t db = -1; (db <= 1) && maximum; ++db)
+			{
+				const int32_t row = (int32_t)bin + db;
+				if ((row < 0) || (row >= bin_count)) continue;
+
+				for (int32_t dv = -1; dv <= 1; ++dv)
+				{
+					if ((db == 0) && (dv == 0)) continue;
+
+					// Doppler axis is circular
+					const uint16_t column = (uint16_t)((velocity + velocity_count + dv) % velocity_count);
+					const float32_t* value = (const float32_t*)&handle->doppler_map[row * velocity_count + column];
+					if ((value[0] * value[0] + value[1] * value[1]) > power[velocity])
+					{
+						maximum = false;
+						break;
+					}
+				}
+			}
+			if (!maximum) continue;
+
+			cfar_detection_insert(handle->detections, RADAR_PROCESSING_MAX_DETECTIONS, &handle->detection_count,
+					params->bin_start + bin, velocity, power[velocity], threshold_squared);
+		}
+	}
+}
+
+/**
+ * @brief Select the region of interest of the frame: window around the predicted peak, or full scan
+ */
+static void roi_select(radar_processing_t* handle)
+{
+	const radar_processing_internal_param_t* params = &handle->params;
+	const int32_t bin_count = params->bin_end - params->bin_start;
+
+	const bool full_scan = !handle->roi_tracking
+			|| ((params->roi_full_scan_period != 0) && (handle->roi_frames >= params->roi_full_scan_period));
+
+	if ((params->roi_half_width == 0) || full_scan)
+	{
+		handle->roi_start = 0;
+		handle->roi_end = bin_count;
+		handle->roi_frames = 0;
+		return;
+	}
+
+	const int32_t predicted = (int32_t)lroundf(handle->roi_position + handle->roi_velocity);
+	int32_t start = predicted - params->roi_half_width;
+	int32_t end = predicted + params->roi_half_width + 1;
+	if (start < 0) start = 0;
+	if (end > bin_count) end = bin_count;
+	if (start >= end)
+	{
+		// Prediction outside of the range gate
+		start = 0;
+		end = bin_count;
+	}
 
-	if (maximum_doppler > internal_params.threshold)
+	handle->roi_start = start;
+	handle->roi_end = end;
+	handle->roi_frames++;
+}
+
+/**
+ * @brief Update the ROI tracking with the peak of the frame (bin inside the range gate)
+ *
+ * The peak is lost if it is below the threshold, or on a border of the region of interest (the target may be outside of it).
+ */
+static void roi_update(radar_processing_t* handle, bool detected, uint16_t bin)
+{
+	const radar_processing_internal_param_t* params = &handle->params;
+	const uint16_t bin_count = params->bin_end - params->bin_start;
+
+	if (params->roi_half_width == 0) return;
+
+	const bool border = ((bin == handle->roi_start) && (handle->roi_start > 0))
+			|| ((bin == handle->roi_end - 1) && (handle->roi_end < bin_count));
+
+	if (!detected || border)
+	{
+		handle->roi_tracking = false;
+		return;
+	}
+
+	if (!handle->roi_tracking)
 	{
-		// Need to compute doppler FFT (but only for range idx = max_bin_idx
-		// we then store the magnitude, the range and the angle difference
-		// then compute the phase difference and store it
+		handle->roi_position = bin;
+		handle->roi_velocity = 0;
+		handle->roi_tracking = true;
+		return;
+	}
 
-		doppler_fft_bin_do(range,
-				doppler_out,		// Doppler FFT output (size is chirps_per_frame)
-				true,				// Remove mean (0 m/s speed)
-				doppler_window,		// Window
-				max_bin_idx,		// Bin index -> Max of RX1
-				2, 					// Antenna index -> RX3
-				internal_params.chirps_per_frame,
-				fft_len);
+	// Alpha-beta filter
+	const float predicted = handle->roi_position + handle->roi_velocity;
+	const float residual = (float)bin - predicted;
+	handle->roi_position = predicted + RADAR_PROCESSING_ROI_ALPHA * residual;
+	handle->roi_velocity += RADAR_PROCESSING_ROI_BETA * residual;
+}
 
-		float phase_rx3 = get_phase(doppler_out[velocity_rx1]);
+/**
+ * @brief Motion gate of radar_processing_feed / radar_processing_feed_finish
+ *
+ * @retval true	Frame idle, result cleared
+ */
+static bool frame_idle(radar_processing_t* handle, const uint16_t* frame_samples, radar_processing_out_t* result)
+{
+	if ((handle->motion_reference == NULL) || detect_motion(handle, frame_samples)) return false;
 
-		doppler_fft_bin_do(range,
-				doppler_out,		// Doppler FFT output (size is chirps_per_frame)
-				true,				// Remove mean (0 m/s speed)
-				doppler_window,		// Window
-				max_bin_idx,		// Bin index -> Max of RX1
-				1, 					// Antenna index -> RX2
-				internal_params.chirps_per_frame,
-				fft_len);
+	handle->detection_count = 0;
+	result->amplitude = 0;
+	result->azimuth = 0;
+	result->range = 0;
+	result->elevation = 0;
+	return true;
+}
 
-		float phase_rx2 = get_phase(doppler_out[velocity_rx1]);
+/**
+ * @brief Stages of radar_processing_feed following the range FFT: range-Doppler map, detection and angles of the strongest target
+ */
+static void process_frame(radar_processing_t* handle, uint16_t* frame_samples, radar_processing_out_t* result)
+{
+	const radar_processing_internal_param_t* params = &handle->params;
 
-		float azimuth = get_angle_diff(phase_rx1, phase_rx3);
-		float elevation = get_angle_diff(phase_rx2, phase_rx3);
+	// Range-Doppler map (only the region of interest with ROI tracking), then extract maximum
+	if (params->detection == RADAR_PROCESSING_DETECTION_THRESHOLD)
+	{
+		roi_select(handle);
+	}
+	compute_map(handle, frame_samples, false);
+
+	float maximum_doppler = 0;
+	float phase_rx1 = 0;
+	uint32_t max_index = 0;
+	bool detected = false;
+
+	if (params->detection == RADAR_PROCESSING_DETECTION_CFAR)
+	{
+		detected = detect_cfar(handle, &maximum_doppler, &phase_rx1, &max_index);
+	}
+	else
+	{
+		handle->detection_count = 0;
+
+		if (handle->doppler_map == NULL)
+		{
+			search_peak_q31(handle, &maximum_doppler, &phase_rx1, &max_index);
+		}
+		else
+		{
+			const uint32_t roi_offset = (uint32_t)handle->roi_start * params->chirps_per_frame;
+
+			get_max_magnitude_phase_velocity(&handle->doppler_map[roi_offset],
+					(uint32_t)(handle->roi_end - handle->roi_start) * params->chirps_per_frame,
+					(float32_t*)handle->doppler_out,		// Work buffer (magnitude squared of one block)
+					2U * params->chirps_per_frame,
+					&maximum_doppler,
+					&phase_rx1,
+					&max_index);
+			max_index += roi_offset;
+		}
+
+		detected = (maximum_doppler > params->threshold);
+		roi_update(handle, detected, max_index / params->chirps_per_frame);
+	}
+
+	// Bin index from [bin_start] to [bin_end - 1]
+	const uint16_t max_bin_idx = params->bin_start + (max_index / params->chirps_per_frame);
+	const uint16_t velocity_rx1 = max_index % params->chirps_per_frame;
+
+	result->amplitude = maximum_doppler;
+
+	if (detected)
+	{
+		float azimuth = 0;
+		float elevation = 0;
+		compute_angles(handle, frame_samples, max_bin_idx, velocity_rx1, phase_rx1, &azimuth, &elevation);
 
 #ifdef DEBUG_RANGE_AZIMUTH
-		printf("%d;%f;\r\n", max_bin_idx, delta);
+		printf("%d;%f;\r\n", max_bin_idx, azimuth);
 #endif
 
 		// max_bin_idx: range
-		// delta: angle of arrival
 		result->azimuth = azimuth;
 		result->range = max_bin_idx;
 		result->elevation = elevation;
@@ -261,6 +1104,131 @@ void radar_processing_feed(uint16_t * frame_samples, radar_processing_out_t* res
 		result->range = 0;
 		result->elevation = 0;
 	}
+
+#ifdef RADAR_PROCESSING_LAZY_RX
+	mti_lazy_update(handle);
+#endif
 }
 
+int radar_processing_feed(radar_processing_t* handle, uint16_t * frame_samples, radar_processing_out_t* result)
+{
+	if ((handle == NULL) || (handle->magic != RADAR_PROCESSING_MAGIC)) return -1;
+	if ((frame_samples == NULL) || (result == NULL)) return -1;
+
+	// The range cube is overwritten -> a frame being streamed is dropped
+	handle->stream_chirps = 0;
+
+	if (frame_idle(handle, frame_samples, result)) return RADAR_PROCESSING_FRAME_IDLE;
+
+	compute_range(handle, frame_samples, 0, handle->params.chirps_per_frame);
+	process_frame(handle, frame_samples, result);
 
+	return RADAR_PROCESSING_FRAME_PROCESSED;
+}
+
+int radar_processing_feed_chirps(radar_processing_t* handle, const uint16_t* chirp_samples, uint16_t first_chirp, uint16_t chirp_count)
+{
+	if ((handle == NULL) || (handle->magic != RADAR_PROCESSING_MAGIC)) return -1;
+	if ((chirp_samples == NULL) || (chirp_count == 0)) return -1;
+	if ((first_chirp + chirp_count) > handle->params.chirps_per_frame) return -1;
+
+	// Chirp 0 starts a new frame, the other blocks must follow the previous one
+	if (first_chirp == 0) handle->stream_chirps = 0;
+	if (first_chirp != handle->stream_chirps) return -2;
+
+	compute_range(handle, chirp_samples, first_chirp, chirp_count);
+	handle->stream_chirps += chirp_count;
+
+	return 0;
+}
+
+int radar_processing_feed_finish(radar_processing_t* handle, uint16_t* frame_samples, radar_processing_out_t* result)
+{
+	if ((handle == NULL) || (handle->magic != RADAR_PROCESSING_MAGIC)) return -1;
+	if ((frame_samples == NULL) || (result == NULL)) return -1;
+	if (handle->stream_chirps != handle->params.chirps_per_frame) return -2;
+
+	handle->stream_chirps = 0;
+
+	if (frame_idle(handle, frame_samples, result)) return RADAR_PROCESSING_FRAME_IDLE;
+
+	process_frame(handle, frame_samples, result);
+
+	return RADAR_PROCESSING_FRAME_PROCESSED;
+}
+
+int radar_processing_feed_targets(radar_processing_t* handle, uint16_t* frame_samples, radar_processing_target_t* targets, uint16_t max_targets)
+{
+	if ((handle == NULL) || (handle->magic != RADAR_PROCESSING_MAGIC)) return -1;
+	if ((frame_samples == NULL) || ((targets == NULL) && (max_targets > 0))) return -1;
+
+	const radar_processing_internal_param_t* params = &handle->params;
+
+	// Local maxima of the threshold detection -> map needed
+	if (handle->doppler_map == NULL) return -2;
+
+	handle->stream_chirps = 0;
+
+	if ((handle->motion_reference != NULL) && !detect_motion(handle, frame_samples))
+	{
+		handle->detection_count = 0;
+		return 0;
+	}
+
+	// Full map (several targets), the pre-screen and the ROI tracking are only used by radar_processing_feed
+	compute_range(handle, frame_samples, 0, params->chirps_per_frame);
+	compute_map(handle, frame_samples, true);
+
+	if (params->detection == RADAR_PROCESSING_DETECTION_CFAR)
+	{
+		float maximum_doppler = 0;
+		float phase_rx1 = 0;
+		uint32_t max_index = 0;
+		detect_cfar(handle, &maximum_doppler, &phase_rx1, &max_index);
+	}
+	else
+	{
+		detect_peaks(handle);
+	}
+
+	const uint16_t target_count = (handle->detection_count < max_targets) ? handle->detection_count : max_targets;
+
+	for (uint16_t i = 0; i < target_count; ++i)
+	{
+		const cfar_detection_t* detection = &handle->detections[i];
+		radar_processing_target_t* target = &targets[i];
+
+		const uint32_t index = (uint32_t)(detection->bin - params->bin_start) * params->chirps_per_frame + detection->velocity;
+
+		arm_sqrt_f32(detection->power, &target->amplitude);
+		target->range = detection->bin;
+		target->velocity = detection->velocity;
+		compute_angles(handle, frame_samples, detection->bin, detection->velocity, get_phase(handle->doppler_map[index]),
+				&target->azimuth, &target->elevation);
+	}
+
+#ifdef RADAR_PROCESSING_LAZY_RX
+	mti_lazy_update(handle);
+#endif
+
+	return target_count;
+}
+
+const float* radar_processing_get_doppler_map(const radar_processing_t* handle, uint16_t* bin_count, uint16_t* velocity_count)
+{
+	if ((handle == NULL) || (handle->magic != RADAR_PROCESSING_MAGIC)) return NULL;
+
+	if (bin_count != NULL) *bin_count = handle->params.bin_end - handle->params.bin_start;
+	if (velocity_count != NULL) *velocity_count = handle->params.chirps_per_frame;
+
+	return (const float*)handle->doppler_map;
+}
+
+const cfar_detection_t* radar_processing_get_detections(const radar_processing_t* handle, uint16_t* count)
+{
+	if ((handle == NULL) || (handle->magic != RADAR_PROCESSING_MAGIC)) return NULL;
+
+	if (count != NULL) *count = handle->detection_count;
+
+	return handle->detections;
+}
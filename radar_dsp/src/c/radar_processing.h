@@ -9,15 +9,66 @@
 #define RADAR_PROCESSING_GESTURE_PROCESSING_H_
 
 #include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "cfar.h"
+
+/**
+ * Alignment of the memory given to radar_processing_init and of every buffer placed inside of it (cache line)
+ */
+#define RADAR_PROCESSING_MEMORY_ALIGNMENT 64U
+
+/**
+ * Arithmetic used for the range and Doppler FFT
+ */
+typedef enum
+{
+	RADAR_PROCESSING_FLOAT32 = 0,	/**< Whole chain in float32 */
+	RADAR_PROCESSING_FIXED_POINT,	/**< Range FFT in Q15, Doppler FFT in Q31 (block floating point), half the RAM for the range buffer.
+									 The map is only stored with the CFAR detection or keep_doppler_map, the peak is searched bin by bin otherwise */
+} radar_processing_arithmetic_t;
+
+/**
+ * Detection done on the range-Doppler map of RX1
+ */
+typedef enum
+{
+	RADAR_PROCESSING_DETECTION_THRESHOLD = 0,	/**< Global maximum of the map compared with a fixed threshold (one target) */
+	RADAR_PROCESSING_DETECTION_CFAR,			/**< CFAR detector (see cfar_do), threshold adapted to the local noise, several targets */
+} radar_processing_detection_t;
+
+/**
+ * Maximum number of detections stored by the CFAR detector (the strongest are kept)
+ */
+#define RADAR_PROCESSING_MAX_DETECTIONS 16
+
+/**
+ * Minimum number of antennas: the angles are computed with RX1, RX2 and RX3 (antenna indexes 0, 1 and 2 of the frame)
+ */
+#define RADAR_PROCESSING_MIN_ANTENNAS 3
 
 typedef struct
 {
-	uint8_t antenna_count;
+	uint8_t antenna_count;	/**< Antennas of the frame, at least RADAR_PROCESSING_MIN_ANTENNAS */
 	uint16_t chirps_per_frame;
 	uint16_t samples_per_chirp;
 	uint32_t sampling_rate;
 	uint64_t start_freq;
 	uint64_t end_freq;
+	radar_processing_arithmetic_t arithmetic;
+	float range_min;	/**< Range gate in meters, only [range_min, range_max] is computed. range_min = range_max = 0 -> complete range */
+	float range_max;
+	radar_processing_detection_t detection;
+	cfar_config_t cfar;	/**< Used with RADAR_PROCESSING_DETECTION_CFAR (e.g. CFAR_CONFIG_DEFAULT) */
+	float mti_alpha;	/**< Background update factor of the MTI stage (see mti_do), 0 -> disabled (only the mean of each frame is removed). Float arithmetic only */
+	float prescreen_factor;	/**< Doppler FFT skipped for the bins with an energy below prescreen_factor * noise floor (median energy of the bins)
+							 that cannot hold the peak of the map (see doppler_fft_energy). 0 -> disabled. Threshold detection only,
+							 radar_processing_feed only (radar_processing_feed_targets computes every bin, the weaker targets could be skipped) */
+	float motion_threshold;	/**< Motion gate: mean absolute difference (ADC LSB) with the last processed frame below which a frame is idle. 0 -> disabled */
+	uint16_t roi_half_width;	/**< ROI tracking: Doppler search restricted to +/- roi_half_width bins around the predicted peak. 0 -> disabled. Threshold detection only */
+	uint16_t roi_full_scan_period;	/**< ROI tracking: a full scan is done at least every roi_full_scan_period frames (0 -> only when the peak is lost) */
+	bool keep_doppler_map;	/**< Fixed point arithmetic: store the range-Doppler map of RX1 (radar_processing_get_doppler_map, radar_processing_feed_targets
+							 with the threshold detection). Always stored with the float arithmetic or the CFAR detection */
 } radar_configuration_t;
 
 // Magnitude, Range, Azimuth, Elevation
@@ -31,8 +82,163 @@ typedef struct
 	float elevation;
 } radar_processing_out_t;
 
-int radar_processing_init(radar_configuration_t radar_configuration);
+/**
+ * Target reported by radar_processing_feed_targets
+ */
+typedef struct
+{
+	float amplitude;
+	float range;		/**< Range bin */
+	float velocity;		/**< Doppler bin, [0] to [chirps per frame - 1] */
+	float azimuth;		/**< Phase difference RX1 - RX3 */
+	float elevation;	/**< Phase difference RX2 - RX3 */
+} radar_processing_target_t;
+
+/**
+ * Radar processing instance (content private, see radar_processing_internal.h)
+ */
+typedef struct radar_processing_s radar_processing_t;
+
+/**
+ * @brief Number of bytes needed by radar_processing_init for the given configuration
+ *
+ * Includes the instance itself and all the buffers (range cube, windows, work buffers)
+ */
+size_t radar_processing_memory_requirement(const radar_configuration_t* radar_configuration);
+
+/**
+ * @brief Create a radar processing instance inside of memory
+ *
+ * No heap is used: the instance and all its buffers are placed inside of memory,
+ * which stays owned by the caller and must be kept until radar_processing_deinit.
+ * Several instances can be used at the same time (each one with its own memory).
+ *
+ * @param [out] handle	Created instance
+ * @param [in] radar_configuration	Configuration
+ * @param [in] memory	Memory used by the instance, aligned on RADAR_PROCESSING_MEMORY_ALIGNMENT
+ * @param [in] memory_size	Size of memory in bytes, at least radar_processing_memory_requirement(radar_configuration)
+ *
+ * @retval 0 	Success
+ * @retval -1	Invalid parameter
+ * @retval -2	memory is not aligned on RADAR_PROCESSING_MEMORY_ALIGNMENT
+ * @retval -3	Range FFT not supported for this configuration
+ * @retval -4	Doppler FFT not supported for this configuration
+ * @retval -5	memory_size too small
+ * @retval -6	CFAR configuration not valid (see cfar_config_check)
+ * @retval -7	MTI not supported for this configuration (fixed point arithmetic)
+ * @retval -8	antenna_count below RADAR_PROCESSING_MIN_ANTENNAS
+ */
+int radar_processing_init(radar_processing_t** handle, const radar_configuration_t* radar_configuration, void* memory, size_t memory_size);
+
+/**
+ * @brief Release an instance. Afterwards, its memory can be reused (e.g. for an instance with another configuration)
+ */
+void radar_processing_deinit(radar_processing_t* handle);
+
+/**
+ * Return values of radar_processing_feed
+ */
+#define RADAR_PROCESSING_FRAME_PROCESSED	0	/**< Frame processed, result updated */
+#define RADAR_PROCESSING_FRAME_IDLE			1	/**< Nothing moved since the last processed frame (motion gate), result cleared, nothing computed */
 
-void radar_processing_feed(uint16_t * frame_samples, radar_processing_out_t* result);
+/**
+ * @brief Process one frame and report the strongest target
+ *
+ * With motion_threshold > 0, a decimated copy of the last processed frame is kept: if the mean absolute difference
+ * of the frame with it is below motion_threshold, the frame is idle and the range / Doppler processing is skipped.
+ *
+ * @param [in] handle	Instance
+ * @param [in] frame_samples	Frame
+ * @param [out] result	Strongest target (all 0 for an idle frame)
+ *
+ * @retval RADAR_PROCESSING_FRAME_PROCESSED
+ * @retval RADAR_PROCESSING_FRAME_IDLE
+ * @retval -1	Invalid parameter
+ */
+int radar_processing_feed(radar_processing_t* handle, uint16_t * frame_samples, radar_processing_out_t* result);
+
+/**
+ * @brief Streaming ingest: range FFT of a block of chirps of the current frame
+ *
+ * Lets the range FFT of the first chirps run while the next ones are acquired (e.g. FIFO interrupt every few chirps):
+ * once the last block is fed, radar_processing_feed_finish only computes the Doppler stage, the detection and the angles.
+ * Blocks must be fed in order, a block starting at chirp 0 starts a new frame.
+ * Same result as radar_processing_feed with the complete frame.
+ *
+ * @param [in] handle	Instance
+ * @param [in] chirp_samples	Raw samples of the chirps [first_chirp, first_chirp + chirp_count[ (same interleaving as a frame)
+ * @param [in] first_chirp	Index of the first chirp of the block
+ * @param [in] chirp_count	Number of chirps of the block
+ *
+ * @retval 0	Success
+ * @retval -1	Invalid parameter
+ * @retval -2	Block does not follow the previous one
+ */
+int radar_processing_feed_chirps(radar_processing_t* handle, const uint16_t* chirp_samples, uint16_t first_chirp, uint16_t chirp_count);
+
+/**
+ * @brief Complete the processing of a frame fed with radar_processing_feed_chirps (see radar_processing_feed)
+ *
+ * The complete frame is still needed: by the motion gate and, with RADAR_PROCESSING_LAZY_RX, by the angle computation and the MTI of RX2 / RX3.
+ * The motion gate is evaluated here, so the range FFT of an idle frame is not saved in this mode.
+ *
+ * @param [in] handle	Instance
+ * @param [in] frame_samples	Complete frame (the chirps given to radar_processing_feed_chirps)
+ * @param [out] result	Strongest target (all 0 for an idle frame)
+ *
+ * @retval RADAR_PROCESSING_FRAME_PROCESSED
+ * @retval RADAR_PROCESSING_FRAME_IDLE
+ * @retval -1	Invalid parameter
+ * @retval -2	Not all the chirps of the frame were fed
+ */
+int radar_processing_feed_finish(radar_processing_t* handle, uint16_t* frame_samples, radar_processing_out_t* result);
+
+/**
+ * @brief Same processing as radar_processing_feed, but report up to max_targets targets
+ *
+ * Targets are the detections of the CFAR detector (RADAR_PROCESSING_DETECTION_CFAR), or the local maxima (3x3 neighbourhood)
+ * of the map above the fixed threshold (RADAR_PROCESSING_DETECTION_THRESHOLD), strongest first.
+ * The angles are computed for each reported target. No memory is allocated: targets is filled by the function.
+ * The whole map is computed, the pre-screen and the ROI tracking are not applied.
+ * An idle frame (motion gate, see radar_processing_feed) reports no target.
+ *
+ * @param [in] handle	Instance
+ * @param [in] frame_samples	Frame
+ * @param [out] targets	Targets, capacity is max_targets
+ * @param [in] max_targets	Capacity of targets (at most RADAR_PROCESSING_MAX_DETECTIONS targets are reported)
+ *
+ * @retval >= 0	Number of targets stored
+ * @retval -1	Invalid parameter
+ * @retval -2	Threshold detection in fixed point without keep_doppler_map (the local maxima need the map)
+ */
+int radar_processing_feed_targets(radar_processing_t* handle, uint16_t* frame_samples, radar_processing_target_t* targets, uint16_t max_targets);
+
+/**
+ * @brief Range-Doppler map of RX1 computed by the last radar_processing_feed (valid until the next one, not updated by idle frames)
+ *
+ * Complex values stored as [real, imag], bin major: map[2 * (bin * velocity_count + velocity)]
+ * Bins are the bins of the range gate: bin 0 is the first bin of the gate
+ *
+ * @param [in] handle	Instance
+ * @param [out] bin_count	Number of range bins of the map (can be NULL)
+ * @param [out] velocity_count	Number of Doppler bins of the map (chirps per frame, can be NULL)
+ *
+ * @retval Map, NULL if the handle is not valid or if the map is not stored (fixed point without keep_doppler_map)
+ */
+const float* radar_processing_get_doppler_map(const radar_processing_t* handle, uint16_t* bin_count, uint16_t* velocity_count);
+
+/**
+ * @brief Detections computed by the last radar_processing_feed / radar_processing_feed_targets (valid until the next one)
+ *
+ * Sorted by decreasing power. bin is the absolute range bin (same unit as radar_processing_out_t::range),
+ * velocity is the Doppler bin.
+ * With RADAR_PROCESSING_DETECTION_THRESHOLD, only filled by radar_processing_feed_targets (snr is then relative to the threshold).
+ *
+ * @param [in] handle	Instance
+ * @param [out] count	Number of detections
+ *
+ * @retval Detections, NULL if the handle is not valid
+ */
+const cfar_detection_t* radar_processing_get_detections(const radar_processing_t* handle, uint16_t* count);
 
 #endif /* RADAR_PROCESSING_GESTURE_PROCESSING_H_ */
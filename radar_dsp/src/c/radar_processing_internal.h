@@ -9,6 +9,9 @@
 #define RADAR_PROCESSING_GESTURE_PROCESSING_INTERNAL_H_
 
 #include <stdint.h>
+#include "radar_processing.h"
+#include "range_fft.h"
+#include "doppler_fft.h"
 
 typedef struct
 {
@@ -23,6 +26,176 @@ typedef struct
 	uint16_t bin_end;
 
 	float threshold;
+
+	radar_processing_arithmetic_t arithmetic;
+
+	radar_processing_detection_t detection;
+	cfar_config_t cfar;
+
+	float mti_alpha;
+
+	float prescreen_factor;
+	float doppler_window_energy;	/**< Sum of the squared Doppler window values */
+
+	float motion_threshold;
+
+	uint16_t roi_half_width;
+	uint16_t roi_full_scan_period;
 } radar_processing_internal_param_t;
 
+/**
+ * Radar processing instance
+ *
+ * Placed at the beginning of the memory given to radar_processing_init, all the buffers follow it
+ * (each one aligned on RADAR_PROCESSING_MEMORY_ALIGNMENT). Buffers not used by the configured arithmetic are NULL.
+ */
+struct radar_processing_s
+{
+	uint32_t magic;
+	radar_processing_internal_param_t params;
+
+	/**
+	 * FFT instances and coefficients of the range / Doppler stages (read only after radar_processing_init)
+	 */
+	range_fft_ctx_t range_ctx;
+	doppler_fft_ctx_t doppler_ctx;
+
+	/**
+	 * Store the converted ADC samples.
+	 * This buffer is used as source for the range FFT (since the raw frame_samples contains interleaved samples).
+	 * Size is 2 * samples per chirp: with RANGE_FFT_PAIRED it holds two antennas (complex buffer of samples per chirp values),
+	 * without, the second half receives the complete spectrum before the range gate is applied.
+	 * With RADAR_PROCESSING_LAZY_RX, also used as work buffer by range_fft_bin_do (also allocated for fixed point).
+	 */
+	float* adc_samples;
+
+	/**
+	 * Window used to be applied on the time signal before computing real FFT
+	 * The ADC scaling is folded into it (see range_fft_window_init)
+	 */
+	float* window;
+
+	/**
+	 * Window used to be applied on the range FFT signal before computing doppler FFT
+	 */
+	float* doppler_window;
+
+	/**
+	 * Store the output of the range computation
+	 * Only the bins of the range gate [bin_start, bin_end[ are stored
+	 * Size is antenna count * chirps per frame * (bin_end - bin_start) * sizeof(cfloat)
+	 * With RADAR_PROCESSING_LAZY_RX, only RX1 is stored (antenna count is 1)
+	 * Layout: RANGE_CUBE_LAYOUT (see radar_processing.c)
+	 * Without range gate, bin_end is samples per chirp / 2
+	 * Why samples per chirp / 2 and not (samples per chirp) / 2 + 1 -> because of the implementation of the FFT
+	 */
+	cfloat32_t* range;
+
+	/**
+	 * Range-Doppler map of RX1 (see doppler_fft_map_do), bin major: doppler_map[bin * chirps per frame + velocity]
+	 * Only the bins of the range gate are stored
+	 * With RANGE_CUBE_BIN_MAJOR (float), the map is computed in place and points to the RX1 part of range
+	 * NULL in fixed point without CFAR or keep_doppler_map: the peak is searched while the Doppler FFT is computed (see search_peak_q31)
+	 */
+	cfloat32_t* doppler_map;
+
+	/**
+	 * Store the result of the doppler FFT for one bin
+	 * doppler_out is the output of the FFT of complex values
+	 */
+	cfloat32_t* doppler_out;
+
+	/**
+	 * Fixed point version of range (RADAR_PROCESSING_FIXED_POINT only)
+	 * Complex values are stored as [real, imag] Q15 -> half the size of range
+	 */
+	q15_t* range_q15;
+
+	/**
+	 * Block exponent of each chirp contained in range_q15
+	 * Size is antenna count * chirps per frame (antenna count is 1 with RADAR_PROCESSING_LAZY_RX)
+	 */
+	int8_t* range_exponent;
+
+	/**
+	 * Work buffer of the Q15 range FFT (3 * samples per chirp)
+	 */
+	q15_t* work_q15;
+
+	/**
+	 * Work buffer of the Q31 Doppler FFT (2 * chirps per frame)
+	 */
+	q31_t* work_q31;
+
+	/**
+	 * Fixed point versions of window and doppler_window
+	 */
+	q15_t* window_q15;
+	q31_t* doppler_window_q31;
+
+	/**
+	 * Background range profile of the MTI stage (mti_alpha > 0 only), background[antenna * (bin_end - bin_start) + bin]
+	 * With RADAR_PROCESSING_LAZY_RX, RX1 is updated by mti_do, RX2 and RX3 (not in the range cube) are subtracted by compute_cell
+	 * and updated at the end of the frame with background_frame
+	 */
+	cfloat32_t* background;
+
+	/**
+	 * RADAR_PROCESSING_LAZY_RX with MTI only: range profile of RX2 and RX3 in the frame (see range_fft_profile_do),
+	 * background_frame[(antenna - 1) * (bin_end - bin_start) + bin]
+	 */
+	cfloat32_t* background_frame;
+	bool background_valid;	/**< Cleared by radar_processing_init, set once the first frame initialized background */
+
+	/**
+	 * Energy pre-screen of the Doppler FFT (prescreen_factor > 0 only)
+	 * bin_energy: slow-time energy of each bin of RX1, followed by a copy used to compute the noise floor (2 * (bin_end - bin_start))
+	 * bin_enabled: bins for which the Doppler FFT is computed (bin_end - bin_start), also used by the ROI tracking
+	 */
+	float32_t* bin_energy;
+	bool* bin_enabled;
+
+	/**
+	 * Region of interest of the current frame: bins [roi_start, roi_end[ of the range gate are searched
+	 */
+	uint16_t roi_start;
+	uint16_t roi_end;
+
+	/**
+	 * ROI tracking (roi_half_width > 0 only): alpha-beta filter of the peak bin (inside the range gate)
+	 */
+	bool roi_tracking;		/**< Peak followed, false -> full scan */
+	float roi_position;		/**< Bins */
+	float roi_velocity;		/**< Bins per frame */
+	uint16_t roi_frames;	/**< Frames since the last full scan */
+
+	/**
+	 * Motion gate (motion_threshold > 0 only): one sample every RADAR_PROCESSING_MOTION_DECIMATION of the last processed frame
+	 */
+	uint16_t* motion_reference;
+	bool motion_reference_valid;
+
+	/**
+	 * Streaming ingest (radar_processing_feed_chirps): number of chirps of the current frame already in the range cube
+	 */
+	uint16_t stream_chirps;
+
+	/**
+	 * Magnitude squared of doppler_map (RADAR_PROCESSING_DETECTION_CFAR only)
+	 * Size is chirps per frame * (bin_end - bin_start)
+	 */
+	float32_t* power;
+
+	/**
+	 * Work buffer of cfar_do (cfar_work_len floats, RADAR_PROCESSING_DETECTION_CFAR only)
+	 */
+	float32_t* cfar_work;
+
+	/**
+	 * Detections of the last frame, bins are absolute range bins
+	 */
+	cfar_detection_t detections[RADAR_PROCESSING_MAX_DETECTIONS];
+	uint16_t detection_count;
+};
+
 #endif /* RADAR_PROCESSING_GESTURE_PROCESSING_INTERNAL_H_ */
@@ -15,28 +15,139 @@
 
 #include "range_fft.h"
 
-int range_fft_do(uint16_t* frame,
+/**
+ * ADC samples are 12 bits -> scale between 0 and 1
+ */
+#define RANGE_FFT_ADC_SCALE (1.f / 4096.f)
+
+void range_fft_window_init(float32_t* win_table, const float32_t* win, uint16_t num_samples_per_chirp)
+{
+	for(uint16_t i = 0; i < num_samples_per_chirp; ++i)
+	{
+		win_table[i] = win[i] * RANGE_FFT_ADC_SCALE;
+	}
+}
+
+/**
+ * @brief Deinterleave, scale, remove mean and apply window in a single read of the chirp samples
+ *
+ * (x[i] / 4096 - mean) * win[i] is computed as (x[i] - raw_mean) * win_table[i]
+ * The raw sum is accumulated as integer while the samples are read, the mean is then removed from the
+ * (contiguous) output buffer, so the interleaved frame is only read once
+ *
+ * @param [in] chirp	First sample of the chirp for the antenna (samples are antenna_count apart)
+ * @param [out] out		Time buffer ready for the real FFT
+ * @param [in] out_stride	Distance between two output samples (1 for the real FFT, 2 to fill the real or imaginary part of a complex buffer)
+ */
+static inline void range_fft_preprocess(const uint16_t* chirp,
+		float32_t* out,
+		uint16_t out_stride,
+		bool mean_removal,
+		const float32_t* win_table,
+		uint8_t antenna_count,
+		uint16_t num_samples_per_chirp)
+{
+	uint32_t sum = 0;
+
+	if (win_table != NULL)
+	{
+		for(uint16_t sample_idx = 0; sample_idx < num_samples_per_chirp; ++sample_idx)
+		{
+			const uint16_t sample = chirp[sample_idx * antenna_count];
+			sum += sample;
+			out[sample_idx * out_stride] = (float32_t)sample * win_table[sample_idx];
+		}
+
+		if (mean_removal)
+		{
+			const float32_t mean = (float32_t)sum / (float32_t)num_samples_per_chirp;
+			for(uint16_t sample_idx = 0; sample_idx < num_samples_per_chirp; ++sample_idx)
+			{
+				out[sample_idx * out_stride] -= mean * win_table[sample_idx];
+			}
+		}
+	}
+	else
+	{
+		for(uint16_t sample_idx = 0; sample_idx < num_samples_per_chirp; ++sample_idx)
+		{
+			const uint16_t sample = chirp[sample_idx * antenna_count];
+			sum += sample;
+			out[sample_idx * out_stride] = (float32_t)sample * RANGE_FFT_ADC_SCALE;
+		}
+
+		if (mean_removal)
+		{
+			const float32_t mean = ((float32_t)sum / (float32_t)num_samples_per_chirp) * RANGE_FFT_ADC_SCALE;
+			for(uint16_t sample_idx = 0; sample_idx < num_samples_per_chirp; ++sample_idx)
+			{
+				out[sample_idx * out_stride] -= mean;
+			}
+		}
+	}
+}
+
+int range_fft_ctx_init(range_fft_ctx_t* ctx, uint16_t num_samples_per_chirp, uint16_t bin_start, uint16_t bin_end, range_fft_layout_t layout)
+{
+	if (ctx == NULL) return -1;
+	if ((bin_start >= bin_end) || (bin_end > (num_samples_per_chirp / 2U))) return IFX_SENSOR_DSP_ARGUMENT_ERROR;
+
+	ctx->num_samples_per_chirp = num_samples_per_chirp;
+	ctx->bin_start = bin_start;
+	ctx->bin_end = bin_end;
+	ctx->layout = layout;
+
+	if (arm_rfft_fast_init_f32(&ctx->rfft, num_samples_per_chirp) != ARM_MATH_SUCCESS) return IFX_SENSOR_DSP_ARGUMENT_ERROR;
+	if (arm_cfft_init_f32(&ctx->cfft, num_samples_per_chirp) != ARM_MATH_SUCCESS) return IFX_SENSOR_DSP_ARGUMENT_ERROR;
+	if (arm_rfft_init_q15(&ctx->rfft_q15, num_samples_per_chirp, 0, 1) != ARM_MATH_SUCCESS) return IFX_SENSOR_DSP_ARGUMENT_ERROR;
+
+	// Goertzel coefficients (only used for narrow gates)
+	ctx->goertzel = range_fft_use_goertzel(num_samples_per_chirp, bin_start, bin_end);
+	if (ctx->goertzel)
+	{
+		for (uint16_t i = 0; i < (bin_end - bin_start); ++i)
+		{
+			const float32_t w = 2.0f * (float32_t)M_PI * (float32_t)(bin_start + i) / (float32_t)num_samples_per_chirp;
+			ctx->goertzel_coef[2 * i] = cosf(w);
+			ctx->goertzel_coef[2 * i + 1] = sinf(w);
+		}
+	}
+
+	return IFX_SENSOR_DSP_STATUS_OK;
+}
+
+/**
+ * @brief Distance (in complex values) between two chirps and between two bins of one antenna inside the range cube
+ */
+static inline void range_fft_strides(const range_fft_ctx_t* ctx, uint16_t num_chirps_per_frame, uint32_t* chirp_stride, uint32_t* bin_stride)
+{
+	if (ctx->layout == RANGE_FFT_LAYOUT_BIN_MAJOR)
+	{
+		*chirp_stride = 1U;
+		*bin_stride = num_chirps_per_frame;
+	}
+	else
+	{
+		*chirp_stride = ctx->bin_end - ctx->bin_start;
+		*bin_stride = 1U;
+	}
+}
+
+int range_fft_do(const range_fft_ctx_t* ctx,
+		uint16_t* frame,
 		cfloat32_t* range,
 		float* adc_samples,
 		bool mean_removal,
 		const float32_t* win,
 		uint8_t antenna_count,
 		uint8_t antenna_mask,
-		uint16_t num_samples_per_chirp,
 		uint16_t num_chirps_per_frame)
 {
     if (frame == NULL) return -1;
     if (range == NULL) return -2;
+    if (ctx == NULL) return -3;
 
-    // Init FFT algorithm
-    static arm_rfft_fast_instance_f32 rfft = { 0 };
-    if (rfft.fftLenRFFT != num_samples_per_chirp)
-    {
-        if (arm_rfft_fast_init_f32(&rfft, num_samples_per_chirp) != ARM_MATH_SUCCESS)
-        {
-            return IFX_SENSOR_DSP_ARGUMENT_ERROR;
-        }
-    }
+    const uint16_t num_samples_per_chirp = ctx->num_samples_per_chirp;
 
     // For each antenna
     for(uint8_t antenna_idx = 0; antenna_idx < antenna_count; ++antenna_idx)
@@ -51,29 +162,532 @@ int range_fft_do(uint16_t* frame,
     	// For each chirp
     	for (uint32_t chirp_idx = 0; chirp_idx < num_chirps_per_frame; ++chirp_idx)
 		{
-    		// The data are interleaved, first need to extract them from the buffer
-    		uint16_t start_index = chirp_idx * antenna_count * num_samples_per_chirp;
+    		// The data are interleaved, extract, scale, remove mean and apply window in one pass
+    		const uint16_t* chirp = &frame[chirp_idx * antenna_count * num_samples_per_chirp + antenna_idx];
+    		range_fft_preprocess(chirp, adc_samples, 1, mean_removal, win, antenna_count, num_samples_per_chirp);
+
+			arm_rfft_fast_f32(&ctx->rfft, adc_samples, (float32_t*)range, 0);
+			CIMAG_F32(range[0]) = 0.0f;
+
+			range += (num_samples_per_chirp / 2U);
+		}
+    }
+
+    return IFX_SENSOR_DSP_STATUS_OK;
+}
+
+/**
+ * @brief Compute one bin of the DFT of x using the Goertzel algorithm
+ *
+ * @param [in] coef	[cos(w), sin(w)] with w = 2 * pi * bin / len
+ */
+static inline void range_fft_goertzel(const float32_t* x, uint16_t len, const float32_t* coef, cfloat32_t* out)
+{
+	const float32_t k = 2.0f * coef[0];
+	float32_t s1 = 0;
+	float32_t s2 = 0;
+
+	for (uint16_t n = 0; n < len; ++n)
+	{
+		const float32_t s0 = x[n] + k * s1 - s2;
+		s2 = s1;
+		s1 = s0;
+	}
+
+	// X = e^(i.w) * s[len - 1] - s[len - 2]
+	CREAL_F32(*out) = coef[0] * s1 - s2;
+	CIMAG_F32(*out) = coef[1] * s1;
+}
+
+bool range_fft_use_goertzel(uint16_t num_samples_per_chirp, uint16_t bin_start, uint16_t bin_end)
+{
+	const uint16_t bin_count = bin_end - bin_start;
+	if (bin_count > RANGE_FFT_GOERTZEL_MAX_BINS) return false;
+
+	// Goertzel: ~ 3 * num_samples_per_chirp operations per bin
+	// Real FFT: ~ (num_samples_per_chirp / 4) * log2(num_samples_per_chirp / 2) butterflies (~ 10 operations each)
+	// plus the split (~ 5 * num_samples_per_chirp operations)
+	uint16_t log2_len = 0;
+	while ((1U << log2_len) < num_samples_per_chirp) log2_len++;
+
+	return ((uint32_t)bin_count * 6U) < ((uint32_t)5U * (log2_len - 1U) + 10U);
+}
+
+int range_fft_gated_do(const range_fft_ctx_t* ctx,
+		uint16_t* frame,
+		cfloat32_t* range,
+		float* work,
+		bool mean_removal,
+		const float32_t* win,
+		uint8_t antenna_count,
+		uint8_t antenna_mask,
+		uint16_t num_chirps_per_frame)
+{
+	return range_fft_gated_chirps_do(ctx, frame, range, work, mean_removal, win, antenna_count, antenna_mask, num_chirps_per_frame, 0, num_chirps_per_frame);
+}
+
+int range_fft_gated_chirps_do(const range_fft_ctx_t* ctx,
+		const uint16_t* chirps,
+		cfloat32_t* range,
+		float* work,
+		bool mean_removal,
+		const float32_t* win,
+		uint8_t antenna_count,
+		uint8_t antenna_mask,
+		uint16_t num_chirps_per_frame,
+		uint16_t first_chirp,
+		uint16_t chirp_count)
+{
+    if (chirps == NULL) return -1;
+    if (range == NULL) return -2;
+    if ((work == NULL) || (ctx == NULL)) return -3;
+    if ((first_chirp + chirp_count) > num_chirps_per_frame) return IFX_SENSOR_DSP_ARGUMENT_ERROR;
+
+    const uint16_t num_samples_per_chirp = ctx->num_samples_per_chirp;
+    const uint16_t bin_start = ctx->bin_start;
+    const uint16_t bin_count = ctx->bin_end - ctx->bin_start;
+
+    uint32_t chirp_stride = 0;
+    uint32_t bin_stride = 0;
+    range_fft_strides(ctx, num_chirps_per_frame, &chirp_stride, &bin_stride);
+
+    float32_t* time = work;
+    float32_t* spectrum = &work[num_samples_per_chirp];
+
+    // For each antenna
+    for(uint8_t antenna_idx = 0; antenna_idx < antenna_count; ++antenna_idx, range += (num_chirps_per_frame * bin_count))
+    {
+    	if (((1 << antenna_idx) & antenna_mask) == 0)
+		{
+    		// Not in the mask - continue
+    		continue;
+		}
+
+    	// For each chirp
+    	for (uint32_t chirp_idx = 0; chirp_idx < chirp_count; ++chirp_idx)
+		{
+    		const uint16_t* chirp = &chirps[chirp_idx * antenna_count * num_samples_per_chirp + antenna_idx];
+    		range_fft_preprocess(chirp, time, 1, mean_removal, win, antenna_count, num_samples_per_chirp);
+
+    		cfloat32_t* out = &range[(first_chirp + chirp_idx) * chirp_stride];
+    		if (ctx->goertzel)
+    		{
+    			for (uint16_t i = 0; i < bin_count; ++i)
+    			{
+    				range_fft_goertzel(time, num_samples_per_chirp, &ctx->goertzel_coef[2 * i], &out[i * bin_stride]);
+    			}
+    		}
+    		else
+    		{
+    			arm_rfft_fast_f32(&ctx->rfft, time, spectrum, 0);
+    			spectrum[1] = 0.0f;
+    			if (bin_stride == 1U)
+    			{
+    				memcpy(out, &spectrum[2 * bin_start], bin_count * sizeof(cfloat32_t));
+    			}
+    			else
+    			{
+    				// Corner turn: the bins of the chirp are num_chirps_per_frame apart
+    				const cfloat32_t* bins = (const cfloat32_t*)&spectrum[2 * bin_start];
+    				for (uint16_t i = 0; i < bin_count; ++i)
+    				{
+    					out[i * bin_stride] = bins[i];
+    				}
+    			}
+    		}
+		}
+    }
+
+    return IFX_SENSOR_DSP_STATUS_OK;
+}
+
+int range_fft_bin_do(const range_fft_ctx_t* ctx,
+		uint16_t* frame,
+		cfloat32_t* range_bin,
+		float* work,
+		bool mean_removal,
+		const float32_t* win,
+		uint8_t antenna_count,
+		uint8_t antenna_index,
+		uint16_t bin_index,
+		uint16_t num_chirps_per_frame)
+{
+    if (frame == NULL) return -1;
+    if (range_bin == NULL) return -2;
+    if ((work == NULL) || (ctx == NULL)) return -3;
+
+    const uint16_t num_samples_per_chirp = ctx->num_samples_per_chirp;
+    if ((antenna_index >= antenna_count) || (bin_index >= (num_samples_per_chirp / 2U))) return IFX_SENSOR_DSP_ARGUMENT_ERROR;
+
+    // Twiddles with the window (and the ADC scaling) folded in: t[n] = win[n] * e^(-i.w.n)
+    // Rotation computed in double, the error stays far below the float resolution
+    const float64_t w = 2.0 * M_PI * (float64_t)bin_index / (float64_t)num_samples_per_chirp;
+    const float64_t cos_w = cos(w);
+    const float64_t sin_w = sin(w);
+    float64_t rot_real = 1.0;
+    float64_t rot_imag = 0.0;
+    float32_t twiddle_sum_real = 0;
+    float32_t twiddle_sum_imag = 0;
+    float32_t* twiddle = work;
+
+    for (uint16_t sample_idx = 0; sample_idx < num_samples_per_chirp; ++sample_idx)
+    {
+    	const float64_t scale = (win != NULL) ? (float64_t)win[sample_idx] : (float64_t)RANGE_FFT_ADC_SCALE;
+    	twiddle[2 * sample_idx] = (float32_t)(scale * rot_real);
+    	twiddle[2 * sample_idx + 1] = (float32_t)(-scale * rot_imag);
+    	twiddle_sum_real += twiddle[2 * sample_idx];
+    	twiddle_sum_imag += twiddle[2 * sample_idx + 1];
+
+    	const float64_t next_real = rot_real * cos_w - rot_imag * sin_w;
+    	rot_imag = rot_imag * cos_w + rot_real * sin_w;
+    	rot_real = next_real;
+    }
+
+    // X = sum((x[n] - mean) * t[n]) = sum(x[n] * t[n]) - mean * sum(t[n]), one read of the interleaved samples per chirp
+    for (uint32_t chirp_idx = 0; chirp_idx < num_chirps_per_frame; ++chirp_idx)
+    {
+    	const uint16_t* chirp = &frame[chirp_idx * antenna_count * num_samples_per_chirp + antenna_index];
+    	uint32_t sum = 0;
+    	float32_t real = 0;
+    	float32_t imag = 0;
+
+    	for (uint16_t sample_idx = 0; sample_idx < num_samples_per_chirp; ++sample_idx)
+    	{
+    		const uint16_t sample = chirp[sample_idx * antenna_count];
+    		sum += sample;
+    		real += (float32_t)sample * twiddle[2 * sample_idx];
+    		imag += (float32_t)sample * twiddle[2 * sample_idx + 1];
+    	}
+
+    	if (mean_removal)
+    	{
+    		const float32_t mean = (float32_t)sum / (float32_t)num_samples_per_chirp;
+    		real -= mean * twiddle_sum_real;
+    		imag -= mean * twiddle_sum_imag;
+    	}
+
+    	CREAL_F32(range_bin[chirp_idx]) = real;
+    	CIMAG_F32(range_bin[chirp_idx]) = imag;
+    }
+
+    return IFX_SENSOR_DSP_STATUS_OK;
+}
+
+int range_fft_profile_do(const range_fft_ctx_t* ctx,
+		const uint16_t* frame,
+		cfloat32_t* profile,
+		float* work,
+		bool mean_removal,
+		const float32_t* win,
+		uint8_t antenna_count,
+		uint8_t antenna_index,
+		uint16_t num_chirps_per_frame)
+{
+    if (frame == NULL) return -1;
+    if (profile == NULL) return -2;
+    if ((work == NULL) || (ctx == NULL)) return -3;
+    if ((antenna_index >= antenna_count) || (num_chirps_per_frame == 0)) return IFX_SENSOR_DSP_ARGUMENT_ERROR;
+
+    const uint16_t num_samples_per_chirp = ctx->num_samples_per_chirp;
+    const uint16_t bin_start = ctx->bin_start;
+    const uint16_t bin_count = ctx->bin_end - ctx->bin_start;
+
+    float32_t* time = work;
+    float32_t* spectrum = &work[num_samples_per_chirp];
+
+    // Sum of the chirps (integer, in the spectrum part of the work buffer)
+    uint32_t* sum = (uint32_t*)spectrum;
+    memset(sum, 0, num_samples_per_chirp * sizeof(uint32_t));
+    for (uint32_t chirp_idx = 0; chirp_idx < num_chirps_per_frame; ++chirp_idx)
+    {
+    	const uint16_t* chirp = &frame[chirp_idx * antenna_count * num_samples_per_chirp + antenna_index];
+    	for (uint16_t sample_idx = 0; sample_idx < num_samples_per_chirp; ++sample_idx)
+    	{
+    		sum[sample_idx] += chirp[sample_idx * antenna_count];
+    	}
+    }
+
+    // Mean chirp: mean of the (x[n] - mean of the chirp) is the mean chirp minus its own mean
+    uint64_t total = 0;
+    for (uint16_t sample_idx = 0; sample_idx < num_samples_per_chirp; ++sample_idx)
+    {
+    	total += sum[sample_idx];
+    }
+    const float32_t scale = 1.f / (float32_t)num_chirps_per_frame;
+    const float32_t mean = mean_removal ? ((float32_t)total * scale) / (float32_t)num_samples_per_chirp : 0.f;
+    for (uint16_t sample_idx = 0; sample_idx < num_samples_per_chirp; ++sample_idx)
+    {
+    	const float32_t factor = (win != NULL) ? win[sample_idx] : RANGE_FFT_ADC_SCALE;
+    	time[sample_idx] = ((float32_t)sum[sample_idx] * scale - mean) * factor;
+    }
+
+    if (ctx->goertzel)
+    {
+    	for (uint16_t i = 0; i < bin_count; ++i)
+    	{
+    		range_fft_goertzel(time, num_samples_per_chirp, &ctx->goertzel_coef[2 * i], &profile[i]);
+    	}
+    }
+    else
+    {
+    	arm_rfft_fast_f32(&ctx->rfft, time, spectrum, 0);
+    	spectrum[1] = 0.0f;
+    	memcpy(profile, &spectrum[2 * bin_start], bin_count * sizeof(cfloat32_t));
+    }
+
+    return IFX_SENSOR_DSP_STATUS_OK;
+}
+
+int range_fft_paired_do(const range_fft_ctx_t* ctx,
+		uint16_t* frame,
+		cfloat32_t* range,
+		float* work,
+		bool mean_removal,
+		const float32_t* win,
+		uint8_t antenna_count,
+		uint8_t antenna_mask,
+		uint16_t num_chirps_per_frame)
+{
+	return range_fft_paired_chirps_do(ctx, frame, range, work, mean_removal, win, antenna_count, antenna_mask, num_chirps_per_frame, 0, num_chirps_per_frame);
+}
+
+int range_fft_paired_chirps_do(const range_fft_ctx_t* ctx,
+		const uint16_t* chirps,
+		cfloat32_t* range,
+		float* work,
+		bool mean_removal,
+		const float32_t* win,
+		uint8_t antenna_count,
+		uint8_t antenna_mask,
+		uint16_t num_chirps_per_frame,
+		uint16_t first_chirp,
+		uint16_t chirp_count)
+{
+    if (chirps == NULL) return -1;
+    if (range == NULL) return -2;
+    if ((work == NULL) || (ctx == NULL)) return -3;
+    if ((first_chirp + chirp_count) > num_chirps_per_frame) return IFX_SENSOR_DSP_ARGUMENT_ERROR;
+
+    // Narrow gate -> evaluating the bins directly is cheaper than any FFT
+    if (ctx->goertzel)
+    {
+    	return range_fft_gated_chirps_do(ctx, chirps, range, work, mean_removal, win, antenna_count, antenna_mask, num_chirps_per_frame, first_chirp, chirp_count);
+    }
+
+    const uint16_t num_samples_per_chirp = ctx->num_samples_per_chirp;
+    const uint16_t bin_start = ctx->bin_start;
+    const uint16_t bin_count = ctx->bin_end - bin_start;
+    const uint32_t antenna_range_len = num_chirps_per_frame * bin_count;
+
+    uint32_t chirp_stride = 0;
+    uint32_t bin_stride = 0;
+    range_fft_strides(ctx, num_chirps_per_frame, &chirp_stride, &bin_stride);
+
+    uint8_t antenna_idx = 0;
+    for(;;)
+    {
+    	// Search next two antennas of the mask
+    	while ((antenna_idx < antenna_count) && (((1 << antenna_idx) & antenna_mask) == 0)) antenna_idx++;
+    	uint8_t second_idx = antenna_idx + 1;
+    	while ((second_idx < antenna_count) && (((1 << second_idx) & antenna_mask) == 0)) second_idx++;
+
+    	if (antenna_idx >= antenna_count) break;
+
+    	if (second_idx >= antenna_count)
+    	{
+    		// Single antenna left -> real FFT
+    		return range_fft_gated_chirps_do(ctx,
+    				chirps,
+    				range,
+					work,
+					mean_removal,
+					win,
+					antenna_count,
+					(1 << antenna_idx),
+					num_chirps_per_frame,
+					first_chirp,
+					chirp_count);
+    	}
+
+    	for (uint32_t chirp_idx = 0; chirp_idx < chirp_count; ++chirp_idx)
+    	{
+    		cfloat32_t* range_a = &range[antenna_idx * antenna_range_len + (first_chirp + chirp_idx) * chirp_stride];
+    		cfloat32_t* range_b = &range[second_idx * antenna_range_len + (first_chirp + chirp_idx) * chirp_stride];
+
+    		// z[n] = a[n] + i.b[n]
+    		const uint16_t* chirp = &chirps[chirp_idx * antenna_count * num_samples_per_chirp];
+    		range_fft_preprocess(&chirp[antenna_idx], &work[0], 2, mean_removal, win, antenna_count, num_samples_per_chirp);
+    		range_fft_preprocess(&chirp[second_idx], &work[1], 2, mean_removal, win, antenna_count, num_samples_per_chirp);
+
+    		arm_cfft_f32(&ctx->cfft, work, 0, 1);
+
+    		// Split: A[k] = (Z[k] + conj(Z[N-k])) / 2 and B[k] = -i.(Z[k] - conj(Z[N-k])) / 2
+    		for (uint16_t i = 0; i < bin_count; ++i)
+    		{
+    			const uint16_t k = bin_start + i;
+    			const uint16_t mirror = (num_samples_per_chirp - k) & (num_samples_per_chirp - 1);
+    			const float32_t zr = work[2 * k];
+    			const float32_t zi = work[2 * k + 1];
+    			const float32_t cr = work[2 * mirror];
+    			const float32_t ci = -work[2 * mirror + 1];
+
+    			CREAL_F32(range_a[i * bin_stride]) = 0.5f * (zr + cr);
+    			CIMAG_F32(range_a[i * bin_stride]) = 0.5f * (zi + ci);
+    			CREAL_F32(range_b[i * bin_stride]) = 0.5f * (zi - ci);
+    			CIMAG_F32(range_b[i * bin_stride]) = -0.5f * (zr - cr);
+    		}
+    	}
+
+    	antenna_idx = second_idx + 1;
+    }
+
+    return IFX_SENSOR_DSP_STATUS_OK;
+}
+
+void range_fft_window_q15_init(q15_t* win_table, const float32_t* win, uint16_t num_samples_per_chirp)
+{
+	for(uint16_t i = 0; i < num_samples_per_chirp; ++i)
+	{
+		float32_t value = win[i] * 32768.f;
+		if (value > 32767.f) value = 32767.f;
+		if (value < -32768.f) value = -32768.f;
+		win_table[i] = (q15_t)value;
+	}
+}
+
+/**
+ * @brief Windowed sample (before normalization) of the fixed point range FFT
+ *
+ * The samples and the mean are in Q2 (x4), so that the result of the window multiplication fits in 31 bits.
+ * The value in float (same scale as range_fft_do) is: result / 2^RANGE_FFT_Q15_INPUT_SHIFT
+ */
+#define RANGE_FFT_Q15_INPUT_SHIFT 29
+
+static inline int32_t range_fft_q15_sample(int32_t sample, int32_t mean_q2, const q15_t* win, uint16_t sample_idx)
+{
+	const int32_t centered = sample * 4 - mean_q2;
+	if (win == NULL) return centered * 32768;
+	return centered * win[sample_idx];
+}
+
+int range_fft_q15_do(const range_fft_ctx_t* ctx,
+		uint16_t* frame,
+		q15_t* range,
+		int8_t* range_exponent,
+		q15_t* work,
+		bool mean_removal,
+		const q15_t* win,
+		uint8_t antenna_count,
+		uint8_t antenna_mask,
+		uint16_t num_chirps_per_frame)
+{
+	return range_fft_q15_chirps_do(ctx, frame, range, range_exponent, work, mean_removal, win, antenna_count, antenna_mask, num_chirps_per_frame, 0, num_chirps_per_frame);
+}
+
+int range_fft_q15_chirps_do(const range_fft_ctx_t* ctx,
+		const uint16_t* chirps,
+		q15_t* range,
+		int8_t* range_exponent,
+		q15_t* work,
+		bool mean_removal,
+		const q15_t* win,
+		uint8_t antenna_count,
+		uint8_t antenna_mask,
+		uint16_t num_chirps_per_frame,
+		uint16_t first_chirp,
+		uint16_t chirp_count)
+{
+    if (chirps == NULL) return -1;
+    if (range == NULL) return -2;
+    if ((range_exponent == NULL) || (work == NULL) || (ctx == NULL)) return -3;
+    if ((first_chirp + chirp_count) > num_chirps_per_frame) return IFX_SENSOR_DSP_ARGUMENT_ERROR;
+
+    const uint16_t num_samples_per_chirp = ctx->num_samples_per_chirp;
+    const uint16_t bin_start = ctx->bin_start;
+
+    // The real FFT output is downscaled by num_samples_per_chirp / 2
+    int8_t fft_exponent = 0;
+    while ((1U << (fft_exponent + 1)) < num_samples_per_chirp) fft_exponent++;
+
+    q15_t* time = work;
+    q15_t* spectrum = &work[num_samples_per_chirp];
+    const uint16_t bin_count = ctx->bin_end - bin_start;
+
+    uint32_t chirp_stride = 0;
+    uint32_t bin_stride = 0;
+    range_fft_strides(ctx, num_chirps_per_frame, &chirp_stride, &bin_stride);
+
+    // For each antenna
+    for(uint8_t antenna_idx = 0; antenna_idx < antenna_count; ++antenna_idx, range += (num_chirps_per_frame * 2U * bin_count), range_exponent += num_chirps_per_frame)
+    {
+    	if (((1 << antenna_idx) & antenna_mask) == 0)
+		{
+    		// Not in the mask - continue
+    		continue;
+		}
 
+    	// For each chirp
+    	for (uint32_t chirp_idx = 0; chirp_idx < chirp_count; ++chirp_idx)
+		{
+    		// Deinterleave and compute the mean
+    		const uint16_t* chirp = &chirps[chirp_idx * antenna_count * num_samples_per_chirp + antenna_idx];
+    		int32_t sum = 0;
     		for(uint16_t sample_idx = 0; sample_idx < num_samples_per_chirp; ++sample_idx)
     		{
-    			uint16_t index = start_index + sample_idx * antenna_count + antenna_idx;
-    			adc_samples[sample_idx] = ((float)frame[index]) / 4096.f; // Copy and directly scale between 0 and 1
+    			time[sample_idx] = (q15_t)chirp[sample_idx * antenna_count];
+    			sum += time[sample_idx];
     		}
 
-			if (mean_removal)
-			{
-				ifx_mean_removal_f32(adc_samples, num_samples_per_chirp);
-			}
+    		int32_t mean_q2 = 0;
+    		if (mean_removal)
+    		{
+    			mean_q2 = ((sum << 2) + (num_samples_per_chirp / 2)) / num_samples_per_chirp;
+    		}
 
-			if (win != NULL)
-			{
-				arm_mult_f32(adc_samples, win, adc_samples, num_samples_per_chirp);
-			}
+    		// Block floating point: find the biggest value and normalize to [16384, 32767]
+    		int32_t max = 0;
+    		for(uint16_t sample_idx = 0; sample_idx < num_samples_per_chirp; ++sample_idx)
+    		{
+    			int32_t value = range_fft_q15_sample(time[sample_idx], mean_q2, win, sample_idx);
+    			if (value < 0) value = -value;
+    			if (value > max) max = value;
+    		}
 
-			arm_rfft_fast_f32(&rfft, adc_samples, (float32_t*)range, 0);
-			CIMAG_F32(range[0]) = 0.0f;
+    		int8_t shift = 0;
+    		while (max > 32767)
+    		{
+    			max >>= 1;
+    			shift++;
+    		}
+    		while ((max != 0) && (max < 16384))
+    		{
+    			max <<= 1;
+    			shift--;
+    		}
 
-			range += (num_samples_per_chirp / 2U);
+    		for(uint16_t sample_idx = 0; sample_idx < num_samples_per_chirp; ++sample_idx)
+    		{
+    			int32_t value = range_fft_q15_sample(time[sample_idx], mean_q2, win, sample_idx);
+    			time[sample_idx] = (shift >= 0) ? (q15_t)(value >> shift) : (q15_t)(value * (1 << (-shift)));
+    		}
+
+    		arm_rfft_q15(&ctx->rfft_q15, time, spectrum);
+
+    		// Only keep [bin_start, bin_end[
+    		q15_t* out = &range[2U * (first_chirp + chirp_idx) * chirp_stride];
+    		if (bin_stride == 1U)
+    		{
+    			memcpy(out, &spectrum[2 * bin_start], 2U * bin_count * sizeof(q15_t));
+    		}
+    		else
+    		{
+    			for (uint16_t i = 0; i < bin_count; ++i)
+    			{
+    				out[2U * i * bin_stride] = spectrum[2 * (bin_start + i)];
+    				out[2U * i * bin_stride + 1U] = spectrum[2 * (bin_start + i) + 1];
+    			}
+    		}
+    		range_exponent[first_chirp + chirp_idx] = shift + fft_exponent - RANGE_FFT_Q15_INPUT_SHIFT;
 		}
     }
 
@@ -17,9 +17,75 @@
 
 #include "ifx_sensor_dsp.h"
 
+/**
+ * Maximum count of bins of a range gate computed with the Goertzel algorithm instead of a FFT
+ */
+#define RANGE_FFT_GOERTZEL_MAX_BINS 16
+
+/**
+ * Memory layout of the range cube written by range_fft_gated_do, range_fft_paired_do and range_fft_q15_do
+ */
+typedef enum
+{
+	RANGE_FFT_LAYOUT_CHIRP_MAJOR = 0,	/**< range[antenna][chirp][bin]: one chirp is contiguous */
+	RANGE_FFT_LAYOUT_BIN_MAJOR,			/**< range[antenna][bin][chirp]: one bin is contiguous (input of the Doppler FFT) */
+} range_fft_layout_t;
+
+/**
+ * Range FFT context
+ *
+ * Contains the FFT instances and the coefficients for a given chirp length and range gate.
+ * Created once with range_fft_ctx_init and only read by the range_fft_* functions, so several contexts
+ * (different sizes) can be used interleaved and one context can be shared by concurrent calls
+ * (each call with its own range and work buffers).
+ */
+typedef struct
+{
+	arm_rfft_fast_instance_f32 rfft;	/**< Real FFT (float) */
+	arm_cfft_instance_f32 cfft;			/**< Complex FFT used by range_fft_paired_do */
+	arm_rfft_instance_q15 rfft_q15;		/**< Real FFT (Q15) */
+	uint16_t num_samples_per_chirp;
+	uint16_t bin_start;
+	uint16_t bin_end;
+	range_fft_layout_t layout;
+	bool goertzel;						/**< True if the gate is narrow enough to use the Goertzel algorithm */
+	float32_t goertzel_coef[2 * RANGE_FFT_GOERTZEL_MAX_BINS];
+} range_fft_ctx_t;
+
+/**
+ * @brief Initialize a range FFT context
+ *
+ * @param [out] ctx	Context to initialize
+ * @param [in] num_samples_per_chirp	Number of ADC samples per chirp
+ * @param [in] bin_start	First bin of the range gate (range_fft_gated_do, range_fft_paired_do, range_fft_q15_do)
+ * @param [in] bin_end		End of the range gate (excluded), maximum is num_samples_per_chirp / 2 (complete range)
+ * @param [in] layout		Layout of the range cube (range_fft_gated_do, range_fft_paired_do, range_fft_q15_do)
+ *
+ * @retval 0 	Success
+ * @retval != 0	Error occurred
+ */
+int range_fft_ctx_init(range_fft_ctx_t* ctx, uint16_t num_samples_per_chirp, uint16_t bin_start, uint16_t bin_end, range_fft_layout_t layout);
+
+/**
+ * @brief Generate the window table used by range_fft_do
+ *
+ * The ADC scaling (1 / 4096) is folded into the window, so that deinterleaving, scaling, mean removal
+ * and windowing can be done in a single pass over the frame
+ *
+ * @param [out] win_table	Generated table. Size of this buffer should be num_samples_per_chirp
+ * 							Can be the same buffer as win (computation in place)
+ *
+ * @param [in] win		Window (e.g. generated using ifx_window_blackmanharris_f32)
+ *
+ * @param [in] num_samples_per_chirp	Number of ADC samples per chirp
+ */
+void range_fft_window_init(float32_t* win_table, const float32_t* win, uint16_t num_samples_per_chirp);
+
 /**
  * @brief Perform range FFT on the samples contained inside the frame buffer
  *
+ * @param [in] ctx		Range FFT context (see range_fft_ctx_init), the range gate and the layout are not used
+ *
  * @param [in] frame	Contains the samples (between 0 and 4096) measured by the radar.
  * 						Size of this buffer should be: antenna_count * num_chirps_per_frame * num_samples_per_chirp
  * 						The samples are interleaved
@@ -36,27 +102,259 @@
  *
  * @param [in] mean_removal	If true, mean will be subtracted from the time buffer
  *
- * @param [in] win		Window to be applied on time buffer before computing FFT
+ * @param [in] win		Window table generated by range_fft_window_init (window with the ADC scaling folded in)
+ * 						If NULL, the samples are only scaled between 0 and 1
  *
  * @param [in] antenna_count	Number of antennas
  *
  * @param [in] antenna_mask		Mask used to specify which antenna should be computed
  *
- * @param [in] num_samples_per_chirp	Number of ADC samples per chirp
- *
  * @param [in] num_chirps_per_frame		Number of chirps per frame
  *
  * @retval 0 	Success
  * @retval != 0	Error occurred
  */
-int range_fft_do(uint16_t* frame,
+int range_fft_do(const range_fft_ctx_t* ctx,
+		uint16_t* frame,
 		cfloat32_t* range,
 		float* adc_samples,
 		bool mean_removal,
 		const float32_t* win,
 		uint8_t antenna_count,
 		uint8_t antenna_mask,
-		uint16_t num_samples_per_chirp,
 		uint16_t num_chirps_per_frame);
 
+/**
+ * @brief Range gated version of range_fft_do: only the bins [bin_start, bin_end[ of the context are computed and stored
+ *
+ * For narrow gates (see range_fft_use_goertzel), each bin is evaluated directly with the Goertzel algorithm,
+ * otherwise the complete real FFT is computed and only the bins of the gate are kept.
+ *
+ * @param [inout] range	Contains the result of the range FFT computation
+ * 						Size of this buffer is antenna_count * num_chirps_per_frame * (bin_end - bin_start)
+ * 						With RANGE_FFT_LAYOUT_CHIRP_MAJOR:
+ * 						range[0] -> antenna 0, chirp 0, range index bin_start
+ * 						range[1] -> antenna 0, chirp 0, range index bin_start + 1
+ *						range[bin_end - bin_start] -> antenna 0, chirp 1, range index bin_start
+ * 						With RANGE_FFT_LAYOUT_BIN_MAJOR:
+ * 						range[0] -> antenna 0, chirp 0, range index bin_start
+ * 						range[1] -> antenna 0, chirp 1, range index bin_start
+ *						range[num_chirps_per_frame] -> antenna 0, chirp 0, range index bin_start + 1
+ *
+ * @param [in] work		Work buffer. Size of this buffer should be 2 * num_samples_per_chirp floats
+ *
+ * Other parameters: see range_fft_do
+ *
+ * @retval 0 	Success
+ * @retval != 0	Error occurred
+ */
+int range_fft_gated_do(const range_fft_ctx_t* ctx,
+		uint16_t* frame,
+		cfloat32_t* range,
+		float* work,
+		bool mean_removal,
+		const float32_t* win,
+		uint8_t antenna_count,
+		uint8_t antenna_mask,
+		uint16_t num_chirps_per_frame);
+
+/**
+ * @brief Chirp subset version of range_fft_gated_do: only the chirps [first_chirp, first_chirp + chirp_count[ of the frame
+ * are transformed and stored at their place in range (the other chirps of range are not modified)
+ *
+ * Used to transform the chirps of a frame while the following ones are still acquired.
+ *
+ * @param [in] chirps	Raw samples of the chirp_count chirps only (same interleaving as frame, chirps[0] is the first sample of first_chirp)
+ * @param [in] num_chirps_per_frame	Number of chirps per frame (size and layout of range)
+ * @param [in] first_chirp	Index of the first chirp contained in chirps
+ * @param [in] chirp_count	Number of chirps contained in chirps, first_chirp + chirp_count <= num_chirps_per_frame
+ *
+ * Other parameters: see range_fft_gated_do
+ *
+ * @retval 0 	Success
+ * @retval != 0	Error occurred
+ */
+int range_fft_gated_chirps_do(const range_fft_ctx_t* ctx,
+		const uint16_t* chirps,
+		cfloat32_t* range,
+		float* work,
+		bool mean_removal,
+		const float32_t* win,
+		uint8_t antenna_count,
+		uint8_t antenna_mask,
+		uint16_t num_chirps_per_frame,
+		uint16_t first_chirp,
+		uint16_t chirp_count);
+
+/**
+ * @brief Check if the bins of the gate are cheaper to evaluate directly (Goertzel) than using a FFT
+ */
+bool range_fft_use_goertzel(uint16_t num_samples_per_chirp, uint16_t bin_start, uint16_t bin_end);
+
+/**
+ * @brief Same as range_fft_do, but two antennas are transformed with one complex FFT
+ *
+ * The chirp of the first antenna is used as real part and the chirp of the second antenna as imaginary part,
+ * both spectra are then separated after the FFT. arm_rfft_fast_f32 already computes a complex FFT of half the length
+ * plus a split, so the work per antenna is about the same: measured on the host (make bench_range, 64 x 64, mask 0b011)
+ * from 8 % faster (60 us vs 65 us) to 21 % slower (52.3 us vs 43.2 us) than range_fft_gated_do depending on the machine.
+ * Not used by radar_processing unless RANGE_FFT_PAIRED is defined (radar_processing.c).
+ * If the mask contains an odd number of antennas, the last one is computed using the real FFT.
+ * Only the bins [bin_start, bin_end[ are stored, the layout of range is the same as for range_fft_gated_do (layout of the context).
+ * For narrow gates, range_fft_gated_do is used instead (Goertzel).
+ *
+ * @param [in] work		Work buffer. Size of this buffer should be 2 * num_samples_per_chirp floats
+ *
+ * Other parameters: see range_fft_gated_do
+ *
+ * @retval 0 	Success
+ * @retval != 0	Error occurred
+ */
+int range_fft_paired_do(const range_fft_ctx_t* ctx,
+		uint16_t* frame,
+		cfloat32_t* range,
+		float* work,
+		bool mean_removal,
+		const float32_t* win,
+		uint8_t antenna_count,
+		uint8_t antenna_mask,
+		uint16_t num_chirps_per_frame);
+
+/**
+ * @brief Chirp subset version of range_fft_paired_do (see range_fft_gated_chirps_do)
+ */
+int range_fft_paired_chirps_do(const range_fft_ctx_t* ctx,
+		const uint16_t* chirps,
+		cfloat32_t* range,
+		float* work,
+		bool mean_removal,
+		const float32_t* win,
+		uint8_t antenna_count,
+		uint8_t antenna_mask,
+		uint16_t num_chirps_per_frame,
+		uint16_t first_chirp,
+		uint16_t chirp_count);
+
+/**
+ * @brief Compute one range bin of every chirp of one antenna (direct DFT)
+ *
+ * Same values as range_fft_do for this bin, for about 2 * num_samples_per_chirp multiply-accumulate per chirp:
+ * the window is folded into the twiddle factors and the mean is removed after the sum.
+ * Used to evaluate a single range cell of an antenna without computing its range FFT.
+ *
+ * @param [in] ctx		Range FFT context (see range_fft_ctx_init), the range gate and the layout are not used
+ *
+ * @param [out] range_bin	Range value of each chirp: range_bin[chirp_idx]. Size of this buffer is num_chirps_per_frame * sizeof(cfloat32_t)
+ *
+ * @param [in] work		Work buffer. Size of this buffer should be 2 * num_samples_per_chirp floats
+ *
+ * @param [in] antenna_index	Index of the antenna
+ *
+ * @param [in] bin_index	Index of the bin, [0] to [(num_samples_per_chirp / 2) - 1] (not relative to the range gate)
+ *
+ * Other parameters: see range_fft_do
+ *
+ * @retval 0 	Success
+ * @retval != 0	Error occurred
+ */
+int range_fft_bin_do(const range_fft_ctx_t* ctx,
+		uint16_t* frame,
+		cfloat32_t* range_bin,
+		float* work,
+		bool mean_removal,
+		const float32_t* win,
+		uint8_t antenna_count,
+		uint8_t antenna_index,
+		uint16_t bin_index,
+		uint16_t num_chirps_per_frame);
+
+/**
+ * @brief Mean over the chirps of the range values of one antenna (bins of the range gate)
+ *
+ * Same values as the mean of range_fft_gated_do over the chirps, for one range FFT per frame:
+ * the range FFT being linear, the FFT of the mean chirp is computed.
+ * Used by the MTI stage for the antennas that are not in the range cube (background of range_fft_bin_do values).
+ *
+ * @param [in] ctx		Range FFT context (see range_fft_ctx_init), the layout is not used
+ *
+ * @param [out] profile	Mean range value of each bin of the range gate: profile[bin_idx - bin_start]. Size of this buffer is (bin_end - bin_start) * sizeof(cfloat32_t)
+ *
+ * @param [in] work		Work buffer. Size of this buffer should be 2 * num_samples_per_chirp floats
+ *
+ * @param [in] antenna_index	Index of the antenna
+ *
+ * Other parameters: see range_fft_do
+ *
+ * @retval 0 	Success
+ * @retval != 0	Error occurred
+ */
+int range_fft_profile_do(const range_fft_ctx_t* ctx,
+		const uint16_t* frame,
+		cfloat32_t* profile,
+		float* work,
+		bool mean_removal,
+		const float32_t* win,
+		uint8_t antenna_count,
+		uint8_t antenna_index,
+		uint16_t num_chirps_per_frame);
+
+/**
+ * @brief Convert a window into the Q15 table used by range_fft_q15_do
+ *
+ * @param [out] win_table	Generated table. Size of this buffer should be num_samples_per_chirp
+ * @param [in] win		Window (without ADC scaling)
+ * @param [in] num_samples_per_chirp	Number of ADC samples per chirp
+ */
+void range_fft_window_q15_init(q15_t* win_table, const float32_t* win, uint16_t num_samples_per_chirp);
+
+/**
+ * @brief Fixed point version of range_fft_do: range FFT computed in Q15 with block floating point scaling
+ *
+ * Before the FFT, each chirp is normalized to use the full Q15 range. The applied scaling is stored
+ * as exponent per (antenna, chirp), so that:
+ * range value (same scale as range_fft_do) = range[] * 2^range_exponent[antenna_idx * num_chirps_per_frame + chirp_idx]
+ *
+ * @param [inout] range	Contains the bins [bin_start, bin_end[ of the range FFT, complex values stored as [real, imag]
+ * 						Same layout as range_fft_gated_do, size of this buffer is antenna_count * num_chirps_per_frame * (bin_end - bin_start) * 2 q15_t
+ *
+ * @param [out] range_exponent	Block exponent of each chirp. Size of this buffer is antenna_count * num_chirps_per_frame
+ *
+ * @param [in] work		Work buffer. Size of this buffer should be 3 * num_samples_per_chirp q15_t
+ *
+ * @param [in] win		Window table generated by range_fft_window_q15_init (or NULL)
+ *
+ * Other parameters: see range_fft_gated_do
+ *
+ * @retval 0 	Success
+ * @retval != 0	Error occurred
+ */
+int range_fft_q15_do(const range_fft_ctx_t* ctx,
+		uint16_t* frame,
+		q15_t* range,
+		int8_t* range_exponent,
+		q15_t* work,
+		bool mean_removal,
+		const q15_t* win,
+		uint8_t antenna_count,
+		uint8_t antenna_mask,
+		uint16_t num_chirps_per_frame);
+
+/**
+ * @brief Chirp subset version of range_fft_q15_do (see range_fft_gated_chirps_do)
+ *
+ * The exponents of the chirps [first_chirp, first_chirp + chirp_count[ are written in range_exponent (full frame layout).
+ */
+int range_fft_q15_chirps_do(const range_fft_ctx_t* ctx,
+		const uint16_t* chirps,
+		q15_t* range,
+		int8_t* range_exponent,
+		q15_t* work,
+		bool mean_removal,
+		const q15_t* win,
+		uint8_t antenna_count,
+		uint8_t antenna_mask,
+		uint16_t num_chirps_per_frame,
+		uint16_t first_chirp,
+		uint16_t chirp_count);
+
 #endif /* PRESENCE_DETECTION_RANGE_FFT_H_ */
@@ -0,0 +1,115 @@
+import re
+import struct
+import sys
+
+# Decoder of the binary log (see src/c/binlog.h)
+#
+# Usage: python binlog_decode.py <capture> <source> [<source> ...]
+#   capture: raw bytes received from the board (file, or serial port if pyserial is installed, e.g. COM5 or /dev/ttyACM0)
+#   source: C files declaring the messages, X(name, id, "format")
+#
+# Text printed by the board outside of the log (printf) is passed through.
+
+SYNC = 0xA5
+ID_LOST = 0
+
+message_pattern = re.compile(r'X\(\s*(\w+)\s*,\s*(\d+)\s*,\s*"((?:[^"\\]|\\.)*)"\s*\)')
+conversion_pattern = re.compile(r'%[-+ #0]*\d*(?:\.\d+)?(?:hh|h|ll|l|z)?([diouxXfFeEgGc%])')
+
+
+# Read the message table: id -> (name, format)
+def load_messages(paths):
+    messages = {}
+    for path in paths:
+        with open(path, encoding="utf-8", errors="replace") as source:
+            for name, message_id, message_format in message_pattern.findall(source.read()):
+                message_format = message_format.encode().decode("unicode_escape")
+                messages[int(message_id)] = (name, message_format)
+    return messages
+
+
+# Convert the raw 32 bits arguments using the conversions of the C format string
+def format_message(message_format, args):
+    values = []
+    for conversion in conversion_pattern.findall(message_format):
+        if conversion == '%':
+            continue
+        raw = args[len(values)] if len(values) < len(args) else 0
+        if conversion in "fFeEgG":
+            values.append(struct.unpack("<f", struct.pack("<I", raw))[0])
+        elif conversion in "di":
+            values.append(struct.unpack("<i", struct.pack("<I", raw))[0])
+        else:
+            values.append(raw)
+
+    python_format = re.sub(r'(%[-+ #0]*\d*(?:\.\d+)?)(?:hh|h|ll|l|z)?u', r'\1d', message_format)
+    python_format = re.sub(r'(%[-+ #0]*\d*(?:\.\d+)?)(?:hh|h|ll|l|z)', r'\1', python_format)
+    return python_format % tuple(values)
+
+
+# Split the stream into records and text, yield the decoded lines
+# follow: keep waiting for data at the end of the stream (serial port)
+def decode(stream, messages, follow=False):
+    buffer = bytearray()
+    text = bytearray()
+    while True:
+        chunk = stream.read(256)
+        if not chunk:
+            if follow:
+                continue
+            break
+        buffer += chunk
+
+        while len(buffer) > 0:
+            if buffer[0] != SYNC:
+                text.append(buffer.pop(0))
+                if text.endswith(b"\n"):
+                    yield text.decode(errors="replace").rstrip()
+                    text.clear()
+                continue
+
+            if len(buffer) < 2:
+                break
+            length = buffer[1]
+            if len(buffer) < length + 3:
+                break
+
+            payload = bytes(buffer[2:2 + length])
+            if (length < 6) or ((length - 6) % 4 != 0) or ((sum(payload) & 0xFF) != buffer[2 + length]):
+                # Not a record (or corrupted): resynchronize on the next byte
+                text.append(buffer.pop(0))
+                continue
+            del buffer[:length + 3]
+
+            message_id, timestamp = struct.unpack_from("<HI", payload)
+            args = struct.unpack_from("<%dI" % ((length - 6) // 4), payload, 6)
+
+            if message_id == ID_LOST:
+                line = "%d messages lost" % args[0]
+            elif message_id in messages:
+                line = format_message(messages[message_id][1], args)
+            else:
+                line = "unknown message %d %s" % (message_id, args)
+            yield "[%10d] %s" % (timestamp, line.rstrip())
+
+
+def is_serial_port(path):
+    return path.startswith("COM") or path.startswith("/dev/")
+
+
+def open_capture(path):
+    if is_serial_port(path):
+        import serial
+        return serial.Serial(path, 115200, timeout=1)
+    return open(path, "rb")
+
+
+if __name__ == "__main__":
+    if len(sys.argv) < 3:
+        print("Usage: python binlog_decode.py <capture> <source> [<source> ...]")
+        sys.exit(1)
+
+    message_table = load_messages(sys.argv[2:])
+    with open_capture(sys.argv[1]) as capture:
+        for decoded in decode(capture, message_table, is_serial_port(sys.argv[1])):
+            print(decoded)